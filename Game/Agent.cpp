@@ -0,0 +1,65 @@
+#include "Agent.h"
+
+int ConsoleAgent::decide_bid(const BidView &view) {
+  switch (view.stage) {
+  case BID_CALL:
+    std::cout << "Player " << view.player
+              << " decide to be landlord (1 for true, 0 for false): \n";
+    break;
+  case BID_ROB:
+    std::cout << "Player " << view.player
+              << ": do you want to pick the landlord?\n";
+    break;
+  case BID_KEEP:
+    std::cout << "Player " << view.player
+              << ": do you want to be landlord?\n";
+    break;
+  case BID_POINTS:
+    std::cout << "Player " << view.player << ": bid " << view.highest + 1
+              << " to 3 points, or 0 to pass\n";
+    int input;
+    std::cin >> input;
+    return input > view.highest && input <= 3 ? input : 0;
+  }
+  int input;
+  std::cin >> input;
+  return input == 1 ? 1 : 0;
+}
+
+int ConsoleAgent::decide_move(const MoveView &view,
+                              std::span<const Move> moves) {
+  int index = 0;
+  for (const auto &move : moves) {
+    std::cout << index++ << " ---\t" << move.to_card_set(view.hand) << '\n';
+  }
+  bool lead = view.last_play.is_none();
+  int choice;
+  while (std::cin >> choice) {
+    if (choice < -1 || choice >= index) {
+      std::cout << "Invaid index, choose again: \n";
+    } else if (choice == -1 && lead) {
+      // The first player cannot give up
+      std::cout << "The first one can not give up. Repeat: \n";
+    } else {
+      return choice;
+    }
+  }
+  // Input is closed, play the first move if it has to
+  return lead ? 0 : -1;
+}
+
+int RandomAgent::decide_bid(const BidView &view) {
+  if (view.stage == BID_POINTS) {
+    int points = gen.bounded(4);
+    return points > view.highest ? points : 0;
+  }
+  return gen.bounded(2);
+}
+
+int RandomAgent::decide_move(const MoveView &view,
+                             std::span<const Move> moves) {
+  if (view.last_play.is_none()) {
+    return gen.bounded(moves.size());
+  }
+  return (int)gen.bounded(moves.size() + 1) - 1;
+}
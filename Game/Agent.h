@@ -0,0 +1,101 @@
+#ifndef AGENT
+#define AGENT
+
+#include <array>
+#include <span>
+
+#include "Belief.h"
+#include "Card.h"
+#include "Hand.h"
+#include "Move.h"
+#include "Random.h"
+
+enum bid_stage_t {
+  BID_CALL, // 叫地主: want to be the landlord?
+  BID_ROB,  // 抢地主: want to take the landlord from the caller?
+  BID_KEEP, // The caller, after being robbed: still want to be the landlord?
+  BID_POINTS, // 叫分: 1 to 3 points, more than the highest bid, or 0 to pass
+};
+
+// How the landlord is decided, see Auction
+enum bid_rule_t {
+  RULE_ROB,    // 叫地主 then 抢地主
+  RULE_POINTS, // 叫分: the highest bid wins, 3 ends the bidding at once
+};
+
+/**
+ * @brief What a player can see when deciding the landlord
+ */
+struct BidView {
+  int player;
+  const Hand &hand;
+  bid_stage_t stage;
+  // BID_POINTS: the highest bid so far, 0 if none
+  int highest;
+};
+
+/**
+ * @brief What a player can see when it is its turn to play
+ */
+struct MoveView {
+  int player;
+  int landlord;
+  const Hand &hand;
+  // Move::none() if the player leads the round, and can not pass
+  const Move &last_play;
+  int last_player;
+  int hand_size[3];
+  // Cards played so far by each player
+  const std::array<Hand, 3> &played;
+  // The 3 cards shown to everyone before the landlord took them
+  const Hand &landlord_cards;
+  // What the player knows of the other hands, from all of the above
+  const Belief &belief;
+};
+
+/**
+ * @brief Interface of a player. The game asks it for every decision.
+ */
+class Agent {
+public:
+  virtual ~Agent() = default;
+
+  /**
+   * @return 1 for yes, 0 for no, or the points for BID_POINTS
+   */
+  virtual int decide_bid(const BidView &view) = 0;
+
+  /**
+   * @param moves Legal moves that beat the last play, never empty
+   * @return Index in moves, or -1 to pass (not allowed when leading)
+   */
+  virtual int decide_move(const MoveView &view,
+                          std::span<const Move> moves) = 0;
+};
+
+/**
+ * @brief A human player typing decisions on the console
+ */
+class ConsoleAgent : public Agent {
+public:
+  int decide_bid(const BidView &view) override;
+  int decide_move(const MoveView &view,
+                  std::span<const Move> moves) override;
+};
+
+/**
+ * @brief Bid at random and choose uniformly among the moves and passing
+ */
+class RandomAgent : public Agent {
+private:
+  Random gen;
+
+public:
+  explicit RandomAgent(uint64_t seed) : gen(seed) {}
+  void seed(uint64_t seed) { gen = Random(seed); }
+  int decide_bid(const BidView &view) override;
+  int decide_move(const MoveView &view,
+                  std::span<const Move> moves) override;
+};
+
+#endif // AGENT
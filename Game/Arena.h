@@ -0,0 +1,41 @@
+#ifndef ARENA
+#define ARENA
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "Profile.h"
+
+/**
+ * @brief Memory for the short-lived objects of one turn or one search node.
+ *
+ * Allocation is a pointer bump in a buffer owned by the arena, and
+ * deallocation does nothing. reset() makes the whole buffer available again,
+ * so once the buffer is large enough nothing touches the global heap. If a
+ * turn needs more than the buffer, the extra memory comes from the heap and
+ * is freed by reset().
+ *
+ * Not thread-safe: use one arena per thread.
+ */
+class Arena {
+private:
+  std::unique_ptr<std::byte[]> buffer;
+  std::pmr::monotonic_buffer_resource resource;
+
+public:
+  static constexpr size_t DEFAULT_SIZE = 256 * 1024;
+
+  explicit Arena(size_t size = DEFAULT_SIZE)
+      : buffer(new std::byte[size]),
+        resource(buffer.get(), size, Profile::heap()) {}
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  std::pmr::memory_resource *get() { return &resource; }
+
+  // Free everything allocated since the last reset
+  void reset() { resource.release(); }
+};
+
+#endif // ARENA
@@ -0,0 +1,65 @@
+#include "Auction.h"
+
+Auction::Auction(int _first_bidder, bid_rule_t _rule)
+    : first_bidder(_first_bidder), rule(_rule), player(_first_bidder),
+      stage(_rule == RULE_POINTS ? BID_POINTS : BID_CALL), landlord(-1),
+      candidate(-1), highest(0), answered(0) {}
+
+void Auction::finish(int _landlord) {
+  landlord = _landlord;
+  player = -1;
+}
+
+bool Auction::is_valid(int answer) const {
+  if (stage == BID_POINTS) {
+    return answer == 0 || (answer > highest && answer <= 3);
+  }
+  return answer == 0 || answer == 1;
+}
+
+void Auction::bid(int answer) {
+  assert(!is_done());
+  assert(is_valid(answer));
+  switch (stage) {
+  case BID_CALL:
+    if (answer == 1) {
+      landlord = player;
+      stage = BID_ROB;
+      player = (landlord + 1) % 3;
+      return;
+    }
+    player = (player + 1) % 3;
+    if (player == first_bidder) {
+      finish(-1);
+    }
+    return;
+  case BID_ROB:
+    if (answer == 1 && candidate == -1) {
+      candidate = player;
+    }
+    player = (player + 1) % 3;
+    if (player == landlord) {
+      if (candidate == -1) {
+        finish(landlord);
+      } else {
+        stage = BID_KEEP;
+      }
+    }
+    return;
+  case BID_KEEP:
+    finish(answer == 0 ? candidate : landlord);
+    return;
+  case BID_POINTS:
+    if (answer > highest) {
+      highest = answer;
+      landlord = player;
+    }
+    answered++;
+    if (highest == 3 || answered == 3) {
+      finish(landlord);
+      return;
+    }
+    player = (player + 1) % 3;
+    return;
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef AUCTION
+#define AUCTION
+
+#include <cassert>
+
+#include "Agent.h"
+
+/**
+ * @brief The bidding for the landlord, one answer at a time.
+ *
+ * 叫地主: starting from the first bidder, players are asked in turn whether
+ * they want to be the landlord, until one says yes. 抢地主: the two others
+ * are then asked whether they want to take it, and if one of them does, the
+ * caller is asked whether it still wants to be the landlord.
+ *
+ * 叫分 (RULE_POINTS): each player in turn bids 1 to 3 points, more than the
+ * highest bid so far, or passes with 0. A bid of 3 ends the bidding at once,
+ * otherwise the highest bidder is the landlord after everyone answered once.
+ *
+ * Nothing here waits for the answers, so the same auction works for a local
+ * Game and for a table whose players answer over the network.
+ */
+class Auction {
+private:
+  int first_bidder;
+  bid_rule_t rule;
+  // The player to answer, -1 when done
+  int player;
+  bid_stage_t stage;
+  // The caller, then the landlord once done
+  int landlord;
+  // The first player who wanted to take the landlord from the caller
+  int candidate;
+  // RULE_POINTS: the highest bid so far, and how many players answered
+  int highest;
+  int answered;
+
+  void finish(int _landlord);
+
+public:
+  explicit Auction(int _first_bidder, bid_rule_t _rule = RULE_ROB);
+
+  bool is_done() const { return player == -1; }
+  // The player to answer and what it is asked
+  int get_player() const { return player; }
+  bid_stage_t get_stage() const { return stage; }
+
+  // 0 or 1, or for BID_POINTS 0 or more than get_highest() up to 3
+  bool is_valid(int answer) const;
+  // Answer of get_player(), must be valid
+  void bid(int answer);
+
+  bid_rule_t get_rule() const { return rule; }
+  // RULE_POINTS: the highest bid so far, the stake once done
+  int get_highest() const { return highest; }
+
+  // -1 if nobody wanted to be the landlord: deal again
+  int get_landlord() const {
+    assert(is_done());
+    return landlord;
+  }
+};
+
+#endif // AUCTION
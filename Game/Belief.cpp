@@ -0,0 +1,125 @@
+#include "Belief.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace {
+
+const uint64_t ALL_CARDS = (1ULL << 54) - 1;
+
+// Tries with the caps before sampling without them
+constexpr int CAPPED_TRIES = 2;
+
+} // namespace
+
+Belief::Belief(int _observer, const Hand &_hand, int _landlord,
+               const Hand &landlord_cards)
+    : observer(_observer), landlord(_landlord), hand(_hand.get_cards()),
+      unseen(ALL_CARDS & ~hand), known{0, 0, 0}, hand_size{17, 17, 17} {
+  hand_size[landlord] = 20;
+  assert(std::popcount(hand) == hand_size[observer]);
+  if (observer != landlord) {
+    known[landlord] = landlord_cards.get_cards() & unseen;
+    unseen &= ~known[landlord];
+  }
+  std::fill(&caps[0][0], &caps[0][0] + 3 * Hand::RANK_NUM, 4);
+}
+
+void Belief::play(int player, uint64_t cards) {
+  hand_size[player] -= std::popcount(cards);
+  if (player == observer) {
+    assert((hand & cards) == cards);
+    hand &= ~cards;
+    return;
+  }
+  assert(((unseen | known[player]) & cards) == cards);
+  unseen &= ~cards;
+  known[player] &= ~cards;
+  // A guess proved wrong
+  for (int r = 0; r < Hand::RANK_NUM; r++) {
+    if (std::popcount(cards & Hand::rank_card_mask(r)) > caps[player][r]) {
+      caps[player][r] = 4;
+    }
+  }
+}
+
+void Belief::pass(int player, const Move &last_play, int last_player) {
+  if (player == observer || last_play.is_none()) {
+    return;
+  }
+  // Passing on the partner tells nothing
+  if (player != landlord && last_player != landlord) {
+    return;
+  }
+  int n;
+  switch (last_play.get_type_t()) {
+  case Single:
+    n = 1;
+    break;
+  case Double:
+    n = 2;
+    break;
+  case Triple:
+  case ThreeOne:
+  case ThreeTwo:
+    n = 3;
+    break;
+  default:
+    return;
+  }
+  for (int r = last_play.rank + 1; r < Hand::RANK_NUM; r++) {
+    int held = std::popcount(known[player] & Hand::rank_card_mask(r));
+    caps[player][r] = std::min<int>(caps[player][r], std::max(n - 1, held));
+  }
+}
+
+bool Belief::deal(Random &rng, bool use_caps, uint64_t cards[3]) const {
+  int a = (observer + 1) % 3;
+  int b = (observer + 2) % 3;
+  int room[3];
+  for (int p : {a, b}) {
+    room[p] = hand_size[p] - std::popcount(known[p]);
+    cards[p] = known[p];
+  }
+  cards[observer] = hand;
+  assert(room[a] + room[b] == std::popcount(unseen));
+
+  for (int r = Hand::RANK_NUM - 1; r >= 0; r--) {
+    uint64_t rank_cards = Hand::rank_card_mask(r);
+    int count[3];
+    count[a] = std::popcount(cards[a] & rank_cards);
+    count[b] = std::popcount(cards[b] & rank_cards);
+    for (uint64_t m = unseen & rank_cards; m; m &= m - 1) {
+      bool to_a = room[a] > 0 && (!use_caps || count[a] < caps[a][r]);
+      bool to_b = room[b] > 0 && (!use_caps || count[b] < caps[b][r]);
+      int p;
+      if (to_a && to_b) {
+        p = (int)rng.bounded(room[a] + room[b]) < room[a] ? a : b;
+      } else if (to_a || to_b) {
+        p = to_a ? a : b;
+      } else {
+        return false;
+      }
+      cards[p] |= m & -m;
+      room[p]--;
+      count[p]++;
+    }
+  }
+  return true;
+}
+
+void Belief::sample(Random &rng, Hand hands[3]) const {
+  uint64_t cards[3];
+  bool done = false;
+  for (int i = 0; i < CAPPED_TRIES && !done; i++) {
+    done = deal(rng, true, cards);
+  }
+  if (!done) {
+    done = deal(rng, false, cards);
+    assert(done && "Without caps every card has a place");
+  }
+  for (int p = 0; p < 3; p++) {
+    hands[p] = Hand::from_cards(cards[p]);
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef BELIEF
+#define BELIEF
+
+#include <cstdint>
+
+#include "Hand.h"
+#include "Move.h"
+#include "Random.h"
+
+/**
+ * @brief What one player knows of the hands of the two others, updated after
+ * every play and pass, and a sampler of hidden hands consistent with it.
+ *
+ * Every card not in the hand of the observer is either played, known to be
+ * in a hand (the landlord cards shown before the landlord took them, until
+ * they are played), or unseen: in one of the two other hands.
+ *
+ * A pass gives a guess: a player who passes on a single, a pair or a triple
+ * of an opponent likely has no more cards of any higher rank than the play
+ * needs. The guess is kept as a cap on the count of every rank of the
+ * player, and only the samples use it. It can be wrong (a player may keep
+ * its 2s for later), so the sampler drops the caps when no deal satisfies
+ * them.
+ *
+ * The sampler deals the unseen cards one by one, from the highest rank down
+ * so that the capped ranks come first. Each card goes to a player with a
+ * probability proportional to the room left in its hand, which gives every
+ * consistent deal the same probability when there is no cap.
+ */
+class Belief {
+private:
+  int observer;
+  int landlord;
+  uint64_t hand;
+  uint64_t unseen;
+  uint64_t known[3];
+  int hand_size[3];
+  // caps[p][r]: at most this many cards of rank r in the hand of p
+  uint8_t caps[3][Hand::RANK_NUM];
+
+  // One try, false if the caps left some card nowhere to go
+  bool deal(Random &rng, bool use_caps, uint64_t cards[3]) const;
+
+public:
+  Belief() = default;
+  /**
+   * @param _hand The hand of the observer, with the landlord cards if it is
+   * the landlord
+   * @param landlord_cards The 3 cards shown to everyone
+   */
+  Belief(int _observer, const Hand &_hand, int _landlord,
+         const Hand &landlord_cards);
+
+  // The cards of the play of player, as removed from its hand
+  void play(int player, uint64_t cards);
+  /**
+   * @param last_play The play passed on, Move::none() if the player led
+   * @param last_player Who made it
+   */
+  void pass(int player, const Move &last_play, int last_player);
+
+  int get_observer() const { return observer; }
+  uint64_t get_unseen() const { return unseen; }
+  // Cards known to be in the hand of player
+  uint64_t get_known(int player) const { return known[player]; }
+  int get_hand_size(int player) const { return hand_size[player]; }
+  int get_cap(int player, int rank) const { return caps[player][rank]; }
+
+  /**
+   * @brief Hands of all players consistent with what the observer knows.
+   *
+   * hands[observer] is the hand of the observer.
+   */
+  void sample(Random &rng, Hand hands[3]) const;
+};
+
+#endif // BELIEF
@@ -0,0 +1,29 @@
+#include "Bidding.h"
+
+void Bidding::strength(const HandBatch &batch, std::vector<int16_t> &out) {
+  out.resize(batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    out[i] = strength(batch.at_least(i, 1), batch.at_least(i, 2),
+                      batch.at_least(i, 3), batch.at_least(i, 4),
+                      batch.sequence(i, 1), batch.rocket(i));
+  }
+}
+
+int Bidding::decide(const BidView &view, const Thresholds &thresholds) {
+  int score = strength(view.hand);
+  switch (view.stage) {
+  case BID_CALL:
+    return score >= thresholds.call ? 1 : 0;
+  case BID_ROB:
+  case BID_KEEP:
+    return score >= thresholds.rob ? 1 : 0;
+  case BID_POINTS: {
+    int points = 0;
+    while (points < 3 && score >= thresholds.points[points]) {
+      points++;
+    }
+    return points > view.highest ? points : 0;
+  }
+  }
+  return 0;
+}
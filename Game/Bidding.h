@@ -0,0 +1,87 @@
+#ifndef BIDDING
+#define BIDDING
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "Agent.h"
+#include "Hand.h"
+#include "HandBatch.h"
+#include "Sequence.h"
+
+/**
+ * @brief Bidding for the landlord from a hand-strength score.
+ *
+ * The score only looks at the masks of HandBatch, so it costs a few popcounts
+ * per hand and scores whole batches of deals at once:
+ * - control: cards that win rounds, 2 points per 2, 3 for the black joker,
+ *   4 for the red one, 6 per bomb and 4 more for the rocket;
+ * - minus an estimate of the plays needed to get rid of the hand: one per
+ *   rank, less the ranks a straight of singles takes in one play, less one
+ *   per triple that can take a kicker.
+ *
+ * A player bids when the score reaches a threshold of the stage. The default
+ * thresholds are quantiles of the score over random 17-card hands: the best
+ * 45% call (BID_CALL), the best 25% rob, and BID_POINTS bids 1, 2 and 3
+ * points with the best 45%, 25% and 11%.
+ */
+namespace Bidding {
+
+struct Thresholds {
+  int call;
+  // BID_ROB and BID_KEEP
+  int rob;
+  // Least score to bid 1, 2 and 3 points
+  int points[3];
+};
+
+constexpr Thresholds DEFAULT = {1, 3, {1, 3, 6}};
+
+inline int strength(uint16_t singles, uint16_t pairs, uint16_t triples,
+                    uint16_t bombs, uint16_t straights, bool rocket) {
+  constexpr uint16_t TWO = 1 << Hand::RANK_TWO;
+  constexpr uint16_t BLACK_JOKER = 1 << Hand::RANK_BLACK_JOKER;
+  constexpr uint16_t RED_JOKER = 1 << Hand::RANK_RED_JOKER;
+  int twos = (singles & TWO ? 1 : 0) + (pairs & TWO ? 1 : 0) +
+             (triples & TWO ? 1 : 0) + (bombs & TWO ? 1 : 0);
+  int control = 2 * twos + (singles & BLACK_JOKER ? 3 : 0) +
+                (singles & RED_JOKER ? 4 : 0) + 6 * std::popcount(bombs) +
+                (rocket ? 4 : 0);
+
+  // A run of k window starts is a straight of k + 4 ranks, played at once
+  int straight_ranks =
+      std::popcount(straights) +
+      3 * std::popcount((uint16_t)(straights & ~(straights << 1)));
+  int kickers = std::min(std::popcount((uint16_t)(triples & ~bombs)),
+                         std::popcount((uint16_t)(singles & ~triples)));
+  int plays = std::popcount(singles) - (rocket ? 1 : 0) - straight_ranks -
+              kickers;
+  return control - plays;
+}
+
+inline int strength(const Hand &hand) {
+  uint16_t singles = hand.ranks_with_at_least(1);
+  uint16_t straights =
+      Sequence::window_starts(singles, Sequence::MIN_LENGTH[1]);
+  constexpr uint16_t JOKERS =
+      1 << Hand::RANK_BLACK_JOKER | 1 << Hand::RANK_RED_JOKER;
+  return strength(singles, hand.ranks_with_at_least(2),
+                  hand.ranks_with_at_least(3), hand.ranks_with_at_least(4),
+                  straights, (singles & JOKERS) == JOKERS);
+}
+
+/**
+ * @brief Bulk mode: the strength of every hand of the batch.
+ *
+ * @param batch Hands already computed with HandBatch::compute()
+ */
+void strength(const HandBatch &batch, std::vector<int16_t> &out);
+
+// The answer to view, as Agent::decide_bid
+int decide(const BidView &view, const Thresholds &thresholds = DEFAULT);
+
+} // namespace Bidding
+
+#endif // BIDDING
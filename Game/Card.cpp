@@ -75,6 +75,18 @@ std::ostream &operator<<(std::ostream &os, const Card &c) {
   return os;
 }
 
+const char *type_name(type_t type) {
+  static const char *const NAMES[TYPE_END] = {
+      "TYPE_START",      "Single",          "Double",
+      "Triple",          "SingleSeq",       "DoubleSeq",
+      "ThreeSeq",        "ThreeOne",        "ThreeTwo",
+      "Airplane_Single", "Airplane_Pair",   "Four_Two_Single",
+      "Four_Two_Pair",   "Bomb",            "UltraBomb",
+  };
+  assert(type >= TYPE_START && type < TYPE_END);
+  return NAMES[type];
+}
+
 std::ostream &operator<<(std::ostream &os, const Type &t) {
   switch (t.type) {
   case SingleSeq:
@@ -91,23 +103,6 @@ std::ostream &operator<<(std::ostream &os, const Type &t) {
   return os;
 }
 
-void Deck::init() {
-  for (int i = 0; i < 54; i++) {
-    cards[i] = Card(i);
-  }
-}
-
-/**
- * @brief Fisher-Yates shuffles
- */
-void Deck::shuffle() {
-  srand(time(NULL));
-  for (int i = 0; i < 54 - 1; i++) {
-    int j = i + (rand() % (54 - i));
-    std::swap(cards[i], cards[j]);
-  }
-}
-
 bool operator==(const Card &lhs, const Card &rhs) {
   if (lhs.suit == RED_JOKER || lhs.suit == BLACK_JOKER)
     return lhs.suit == rhs.suit;
@@ -122,6 +117,22 @@ bool Card::equal_all(const Card &c) {
   return this->suit == c.suit && this->number == c.number;
 }
 
+int Card::get_id() const {
+  if (suit == BLACK_JOKER)
+    return 52;
+  if (suit == RED_JOKER)
+    return 53;
+  return (int)suit * 13 + number - 1;
+}
+
+int Card::get_rank() const {
+  if (suit == BLACK_JOKER)
+    return 13;
+  if (suit == RED_JOKER)
+    return 14;
+  return number < 3 ? number + 10 : number - 3;
+}
+
 bool operator==(const Type &t1, const Type &t2) {
   return (t1.type == t2.type) && (t1.length == t2.length);
 }
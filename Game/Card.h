@@ -30,7 +30,14 @@ public:
 
   friend std::ostream &operator<<(std::ostream &os, const Card &c);
 
+  // Suits too, the only comparison of Card that tells suits apart
   bool equal_all(const Card &c);
+
+  // Index in range [0, 54), the inverse of Card(int num)
+  int get_id() const;
+  // Index in range [0, 15), ordered by strength: 3, 4, ..., K, A, 2, Black
+  // Joker, Red Joker
+  int get_rank() const;
 };
 
 enum type_t {
@@ -46,8 +53,8 @@ enum type_t {
   ThreeOne, // 三带一
   ThreeTwo, // 三带二
 
-  Airplane_Single, // 飞机 (两张)
-  Airplane_Pair,   // 飞机 (两对)
+  Airplane_Single, // 飞机带单: 2 or more triples in a row, a card for each
+  Airplane_Pair,   // 飞机带对: 2 or more triples in a row, a pair for each
 
   Four_Two_Single, // 四带二（两张）
   Four_Two_Pair,   // 四带四（两对）
@@ -57,6 +64,9 @@ enum type_t {
   TYPE_END,  // no type, can not use any kind of types
 };
 
+// The name of the enumerator, "Single" for Single, for reports
+const char *type_name(type_t type);
+
 // Wrapper class to represent special types like (SingleSeq x 5)
 //   or (DoubleSeq x 3)
 class Type {
@@ -69,8 +79,10 @@ public:
   Type(type_t _type) : type(_type), length(0) {
     assert(_type != SingleSeq && _type != DoubleSeq && _type != ThreeSeq);
   }
+  // Sequences and airplanes, a length of 0 stands for all lengths
   Type(type_t _type, int _length) : type(_type), length(_length) {
-    assert(_type == SingleSeq || _type == DoubleSeq || _type == ThreeSeq);
+    assert(_type == SingleSeq || _type == DoubleSeq || _type == ThreeSeq ||
+           _type == Airplane_Single || _type == Airplane_Pair);
   }
   type_t get_type_t() { return type; }
   int get_length() { return length; }
@@ -119,26 +131,4 @@ public:
   friend std::ostream &operator<<(std::ostream &os, const CardSet &card_set);
 };
 
-/**
- * @brief Used in the beginning, when assigning cards to players
- */
-class Deck {
-private:
-  Card cards[54];
-
-  // Indicating current index of the first card in the deck
-  int index;
-
-  void init();
-  void shuffle();
-
-public:
-  Deck() : index(0) {
-    init();
-    shuffle();
-  }
-
-  Card pick() { return cards[index++]; }
-};
-
 #endif // CARD
\ No newline at end of file
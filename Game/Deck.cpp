@@ -0,0 +1,37 @@
+#include "Deck.h"
+
+#include <utility>
+
+#include "Profile.h"
+
+void Deck::init() {
+  for (int i = 0; i < 54; i++) {
+    cards[i] = i;
+  }
+}
+
+/**
+ * @brief Fisher-Yates shuffles
+ */
+void Deck::shuffle(Random &rng) {
+  Profile::Scope scope(Profile::SHUFFLE);
+  for (int i = 0; i < 54 - 1; i++) {
+    int j = i + rng.bounded(54 - i);
+    std::swap(cards[i], cards[j]);
+  }
+}
+
+Deal Deck::deal() const {
+  Profile::Scope scope(Profile::DEAL);
+  uint64_t masks[4] = {0, 0, 0, 0};
+  // The last 3 cards (i / 17 == 3) are for the landlord
+  for (int i = 0; i < 54; i++) {
+    masks[i / 17] |= 1ULL << cards[i];
+  }
+  Deal d;
+  for (int i = 0; i < 3; i++) {
+    d.hands[i] = Hand::from_cards(masks[i]);
+  }
+  d.landlord_cards = Hand::from_cards(masks[3]);
+  return d;
+}
@@ -0,0 +1,55 @@
+#ifndef DECK
+#define DECK
+
+#include <cstdint>
+
+#include "Card.h"
+#include "Hand.h"
+#include "Random.h"
+
+/**
+ * @brief The three hands and the 3 cards left for the landlord
+ */
+struct Deal {
+  Hand hands[3];
+  Hand landlord_cards;
+};
+
+/**
+ * @brief Used in the beginning, when assigning cards to players
+ */
+class Deck {
+private:
+  // Card ids, see Card(int num)
+  uint8_t cards[54];
+
+  // Indicating current index of the first card in the deck
+  int index;
+
+  void init();
+  void shuffle(Random &rng);
+
+public:
+  // Shuffled with the generator of the calling thread
+  Deck() : Deck(thread_random()()) {}
+  // The same seed always gives the same order
+  explicit Deck(uint64_t seed) : index(0) {
+    Random rng(seed);
+    init();
+    shuffle(rng);
+  }
+  Deck(Random &rng) : index(0) {
+    init();
+    shuffle(rng);
+  }
+
+  Card pick() { return Card(cards[index++]); }
+
+  /**
+   * @brief 17 cards for every player and 3 for the landlord, from the whole
+   * deck regardless of the cards already picked
+   */
+  Deal deal() const;
+};
+
+#endif // DECK
@@ -0,0 +1,78 @@
+#include "Evaluator.h"
+
+#include <bit>
+
+#include "Random.h"
+#include "Strategy.h"
+
+Evaluator::Evaluator(int cache_bits)
+    : cache(1ULL << cache_bits, Entry{0, 0}), mask((1ULL << cache_bits) - 1) {}
+
+int Evaluator::min_plays(const Hand &hand) { return search(hand, 0); }
+
+int Evaluator::search(const Hand &hand, int depth) {
+  if (hand.empty()) {
+    return 0;
+  }
+  Entry &entry = cache[Random::mix(hand.get_counts()) & mask];
+  if (entry.plays != 0 && entry.counts == hand.get_counts()) {
+    return entry.plays - 1;
+  }
+
+  if (depth == (int)arenas.size()) {
+    arenas.push_back(std::make_unique<Arena>(64 * 1024));
+  }
+  Arena &arena = *arenas[depth];
+  arena.reset();
+
+  // Counter of the lowest rank in the layout of Hand::get_counts()
+  uint64_t lowest = 0xFULL << (std::countr_zero(hand.get_counts()) & ~3);
+  int best = hand.size();
+  for (const auto &m : Strategy::generate(hand, Move::none(), arena.get())) {
+    if ((m.counts() & lowest) == 0) {
+      continue;
+    }
+    if (m.size() == hand.size()) {
+      best = 1;
+      break;
+    }
+    // Only playing everything at once can still do better
+    if (best == 2) {
+      continue;
+    }
+    Hand rest = hand;
+    rest.remove(m);
+    best = std::min(best, 1 + search(rest, depth + 1));
+  }
+
+  // The slot may have been used by the deeper calls in the meantime
+  cache[Random::mix(hand.get_counts()) & mask] = {hand.get_counts(),
+                                                  (uint8_t)(best + 1)};
+  return best;
+}
+
+std::vector<Move> Evaluator::decompose(const Hand &hand) {
+  std::vector<Move> plays;
+  Hand rest = hand;
+  int left = min_plays(rest);
+  while (!rest.empty()) {
+    uint64_t lowest = 0xFULL << (std::countr_zero(rest.get_counts()) & ~3);
+    bool found = false;
+    for (const auto &m : Strategy::generate(rest, Move::none())) {
+      if ((m.counts() & lowest) == 0) {
+        continue;
+      }
+      Hand next = rest;
+      next.remove(m);
+      if (min_plays(next) == left - 1) {
+        plays.push_back(m);
+        rest = next;
+        left--;
+        found = true;
+        break;
+      }
+    }
+    assert(found && "The minimum is reached by some move");
+  }
+  return plays;
+}
@@ -0,0 +1,53 @@
+#ifndef EVALUATOR
+#define EVALUATOR
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Arena.h"
+#include "Hand.h"
+#include "Move.h"
+
+/**
+ * @brief Minimum number of plays needed to play out a hand, with nobody in
+ * the way (the best split into straights, airplanes, triples with kickers,
+ * bombs and so on).
+ *
+ * Every card is in exactly one play, so some play contains a card of the
+ * lowest rank of the hand: the minimum is 1 + the minimum of the rest, over
+ * the leading moves of Strategy that use that rank (as base or kicker). The
+ * value only depends on the rank counts, so results are cached by
+ * Hand::get_counts() and shared by all the hands met later with the same
+ * counts, in one query or another.
+ *
+ * Not thread-safe: use one evaluator per thread.
+ */
+class Evaluator {
+private:
+  struct Entry {
+    uint64_t counts;
+    // 0 for an empty slot, the minimum + 1 otherwise
+    uint8_t plays;
+  };
+
+  std::vector<Entry> cache;
+  uint64_t mask;
+  // One arena per depth, as the move lists of all ancestors stay alive
+  std::vector<std::unique_ptr<Arena>> arenas;
+
+  int search(const Hand &hand, int depth);
+
+public:
+  /**
+   * @param cache_bits The cache has 2^cache_bits entries
+   */
+  explicit Evaluator(int cache_bits = 16);
+
+  int min_plays(const Hand &hand);
+
+  // One split of the hand into min_plays(hand) moves
+  std::vector<Move> decompose(const Hand &hand);
+};
+
+#endif // EVALUATOR
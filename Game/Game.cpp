@@ -1,170 +1,164 @@
 #include "Game.h"
 #include <cassert>
-#include <chrono>
-#include <cstdlib>
-#include <exception>
-#include <type_traits>
+
+int Game::bid(int player, const Auction &auction) {
+  int answer = agents[player]->decide_bid(
+      {player, players[player], auction.get_stage(), auction.get_highest()});
+  assert(auction.is_valid(answer));
+  record.bids.push_back(answer);
+  return answer;
+}
 
 bool Game::decide_landlord(int &landlord) {
-  landlord = -1;
   // 抢地主
-  srand(time(NULL));
-  int rand_index = rand() % 3;
-  int current_index = rand_index;
-  do {
-    std::cout << "Player " << current_index
-              << " decide to be landlord (1 for true, 0 for false): "
-              << std::endl;
-    int decision_landlord;
-    std::cin >> decision_landlord;
-    if (decision_landlord == 1) {
-      std::cout << "Player " << current_index << " wants to be landlord!"
-                << std::endl;
-      landlord = current_index;
-      break;
-    }
-    current_index = (current_index + 1) % 3;
-  } while (current_index != rand_index);
-
-  if (landlord == -1) {
-    std::cout << "No one wants to be landlord, game restart." << std::endl;
-    return false;
+  int rand_index = rng.bounded(3);
+  record.first_bidder = rand_index;
+  Auction auction(rand_index, rule);
+  while (!auction.is_done()) {
+    int player = auction.get_player();
+    bid_stage_t stage = auction.get_stage();
+    int answer = bid(player, auction);
+    if (!quiet && stage == BID_CALL && answer == 1)
+      std::cout << "Player " << player << " wants to be landlord!\n";
+    if (!quiet && stage == BID_POINTS && answer > 0)
+      std::cout << "Player " << player << " bids " << answer << "!\n";
+    auction.bid(answer);
   }
 
   // 决定地主
-  int next_player = (landlord + 1) % 3;
-  int landlord_candidate = -1;
-  while (next_player != landlord) {
-    std::cout << "Player " << next_player
-              << ": do you want to pick the landlord?" << std::endl;
-    int input;
-    std::cin >> input;
-    if (input == 1) {
-      if (landlord_candidate == -1) {
-        landlord_candidate = next_player;
-      }
-    }
-    next_player = (next_player + 1) % 3;
-  }
-  if (landlord_candidate != -1) {
-    std::cout << "Player " << landlord << ": do you want to be landlord?"
-              << std::endl;
-    int input;
-    std::cin >> input;
-    if (input == 0) {
-      landlord = landlord_candidate;
-    }
+  landlord = auction.get_landlord();
+  if (landlord == -1) {
+    if (!quiet)
+      std::cout << "No one wants to be landlord, game restart.\n";
+    return false;
   }
-  std::cout << "Player " << landlord << " becomes the landlord!" << std::endl;
+  if (!quiet)
+    std::cout << "Player " << landlord << " becomes the landlord!\n";
 
   return true;
 }
 
-void Game::init() {
-  int landlord = 0;
+void Game::init() { init(rng()); }
+
+void Game::init(uint64_t seed) {
+  rng = Random(seed);
+  round = 0;
+  played = {};
+  record.clear();
+  record.seed = seed;
+  record.rule = rule;
+  bool first = true;
   do { // while (!decide_landlord(landlord))
+    if (!first) {
+      record.redeals++;
+    }
+    first = false;
     // shuffle and assign hards here
-    deck = Deck();
+    Deal deal = Deck(rng).deal();
     for (int i = 0; i < 3; i++) {
-      players[i].clear();
-      for (int j = 0; j < 17; j++) {
-        players[i].push_back(deck.pick());
-      }
-    }
-    for (auto &p : players) {
-      std::sort(p.begin(), p.end());
+      players[i] = deal.hands[i];
+      record.hands[i] = players[i].get_cards();
     }
+    landlord_cards = deal.landlord_cards;
+    record.landlord_cards = landlord_cards.get_cards();
     print_state();
 
   } while (!decide_landlord(landlord));
+  record.landlord = landlord;
 
   // 亮地主牌
-  std::vector<Card> landlord_cards;
-  std::cout << "Cards of landlord: ";
-  for (int i = 0; i < 3; i++) {
-    landlord_cards.push_back(deck.pick());
-    std::cout << landlord_cards.back() << " ";
-  }
-  std::cout << std::endl;
-
-  players[landlord].insert(players[landlord].end(), landlord_cards.begin(),
-                           landlord_cards.end());
-
-  for (auto &p : players) {
-    std::sort(p.begin(), p.end());
+  if (!quiet)
+    std::cout << "Cards of landlord: ";
+  for (const auto &c : landlord_cards.to_vector()) {
+    players[landlord].add(c);
+    if (!quiet)
+      std::cout << c << " ";
   }
-  std::cout << "After sort: " << std::endl;
+  if (!quiet)
+    std::cout << "\nAfter sort: \n";
   print_state();
+  for (int i = 0; i < 3; i++) {
+    beliefs[i] = Belief(i, players[i], landlord, landlord_cards);
+  }
 }
 
 void Game::print_state() {
-  std::cout << "Round: " << round << std::endl;
+  if (quiet)
+    return;
+  std::cout << "Round: " << round << '\n';
 
   for (size_t i = 0; i < 3; i++) {
-    std::cout << "Cards of Player " << i << ": " << std::endl;
+    std::cout << "Cards of Player " << i << ": \n";
     std::cout << "\t";
-    for (const auto &c : players[i]) {
+    for (const auto &c : players[i].to_vector()) {
       std::cout << c << " ";
     }
-    std::cout << std::endl;
+    std::cout << '\n';
   }
 }
 
 bool Game::isGameEnd() {
-  return (players[0].size() == 0 || players[1].size() == 0 ||
-          players[2].size() == 0);
+  return players[0].empty() || players[1].empty() || players[2].empty();
 }
 
-void Game::run() {
-  int current_player = 0;
+int Game::run() {
+  // The landlord plays first
+  int current_player = landlord;
   int last_player = -1;
   while (!isGameEnd()) {
-    CardSet last_play(TYPE_START, {});
+    Move last_play = Move::none();
 
     round++;
     print_state();
 
-    while (true) {
+    while (!isGameEnd()) {
       if (current_player == last_player) {
-        std::cout << "Player " << current_player << " wins this round!"
-                  << std::endl;
+        if (!quiet)
+          std::cout << "Player " << current_player << " wins this round!\n";
         last_player = -1;
         break;
       }
-      std::cout << "===== Current player: " << current_player
-                << " =====" << std::endl;
-      std::vector<CardSet> move = Strategy::get_possible_move(
-          players[current_player], last_play.get_type());
-      move = Strategy::trim_by_last_play(move, last_play);
-      int index = 0;
-      for (const auto &move : move) {
-        std::cout << index++ << " ---\t";
-        std::cout << move;
-        std::cout << std::endl;
-      }
-      if (index == 0) {
-        std::cout << "Player " << current_player << " doesn't have choice."
-                  << std::endl;
-      } else {
-        int choice;
-        std::cin >> choice;
-        while (choice < -1 || choice >= index) {
-          std::cout << "Invaid index, choose again: " << std::endl;
-          std::cin >> choice;
+      if (!quiet)
+        std::cout << "===== Current player: " << current_player
+                  << " =====\n";
+      arena.reset();
+      std::pmr::vector<Move> move = Strategy::get_moves(
+          players[current_player], last_play, arena.get());
+      if (move.empty()) {
+        if (!quiet)
+          std::cout << "Player " << current_player << " doesn't have choice.\n";
+        record.moves.push_back(Move::none());
+        for (auto &b : beliefs) {
+          b.pass(current_player, last_play, last_player);
         }
+      } else {
+        MoveView view{current_player,
+                      landlord,
+                      players[current_player],
+                      last_play,
+                      last_player,
+                      {players[0].size(), players[1].size(), players[2].size()},
+                      played,
+                      landlord_cards,
+                      beliefs[current_player]};
+        int choice = agents[current_player]->decide_move(view, move);
+        assert(choice >= -1 && choice < (int)move.size());
         // The first player cannot give up
-        if (last_play.get_type() == TYPE_START) {
-          while (choice == -1) {
-            std::cout << "The first one can not give up. Repeat: " << std::endl;
-            std::cin >> choice;
-          }
-        }
+        assert(choice != -1 || !last_play.is_none());
+        record.moves.push_back(choice == -1 ? Move::none() : move[choice]);
         if (choice == -1) {
-          std::cout << "Player " << current_player << " gives no choice."
-                    << std::endl;
+          if (!quiet)
+            std::cout << "Player " << current_player << " gives no choice.\n";
+          for (auto &b : beliefs) {
+            b.pass(current_player, last_play, last_player);
+          }
         } else {
-          assert(choice >= 0 && choice < index);
-          remove_card_set(move[choice], players[current_player]);
+          uint64_t cards = players[current_player].remove(move[choice]);
+          played[current_player] = Hand::from_cards(
+              played[current_player].get_cards() | cards);
+          for (auto &b : beliefs) {
+            b.play(current_player, cards);
+          }
           last_play = move[choice];
           last_player = current_player;
         }
@@ -174,28 +168,12 @@ void Game::run() {
   }
   for (int i = 0; i < 3; i++) {
     if (players[i].empty()) {
-      std::cout << "Player " << i << " wins the game!" << std::endl;
-      return;
+      if (!quiet)
+        std::cout << "Player " << i << " wins the game!" << std::endl;
+      record.winner = i;
+      return i;
     }
   }
+  assert(0 && "Should not reach here.");
+  return -1;
 }
-
-void Game::remove_card_set(const CardSet &card_set, std::vector<Card> &hand) {
-  // TODO: Improve it later for performance
-  for (const auto &b : card_set.get_base()) {
-    for (auto i = hand.begin(); i != hand.end(); i++) {
-      if (i->equal_all(b)) {
-        hand.erase(i);
-        break;
-      }
-    }
-  }
-  for (const auto &e : card_set.get_extra()) {
-    for (auto i = hand.begin(); i != hand.end(); i++) {
-      if (i->equal_all(e)) {
-        hand.erase(i);
-        break;
-      }
-    }
-  }
-}
\ No newline at end of file
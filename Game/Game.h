@@ -1,19 +1,43 @@
 #ifndef GAME
 #define GAME
 
+#include <array>
+
+#include "Agent.h"
+#include "Arena.h"
+#include "Auction.h"
+#include "Belief.h"
 #include "Card.h"
+#include "Deck.h"
+#include "GameRecord.h"
+#include "Hand.h"
+#include "Random.h"
 #include "Strategy.h"
 
 class Game {
 private:
-  Deck deck;
+  Random rng;
   int round;
-  std::vector<std::vector<Card>> players;
+  std::vector<Hand> players;
+  // The 3 cards shown to everyone and given to the landlord
+  Hand landlord_cards;
+  // Cards played so far by each player, everyone can see them
+  std::array<Hand, 3> played;
+  // What each player knows of the others, updated after every turn
+  std::array<Belief, 3> beliefs;
+  std::array<Agent *, 3> agents;
+  int landlord;
+  // Do not print anything, for simulation
+  bool quiet;
+  bid_rule_t rule;
+  // Move lists of the current turn
+  Arena arena;
+  // The game so far
+  GameRecord record;
+
   void print_state();
   bool isGameEnd();
 
-  void remove_card_set(const CardSet &card_set, std::vector<Card> &hand);
-
   /**
    * @brief Decide who is the landlord.
    *
@@ -23,11 +47,36 @@ private:
    * @return false The landlord is not decided, reshuffle and assing cards
    */
   bool decide_landlord(int &landlord);
+  // Ask the agent of player and record the answer
+  int bid(int player, const Auction &auction);
 
 public:
-  Game() : deck(), round(0), players(3, std::vector<Card>()) {}
+  /**
+   * @param _agents Players, not owned by the game
+   * @param _quiet Do not print anything if true
+   * @param seed Decides the deals and the first bidder
+   * @param _rule How the landlord is decided
+   */
+  Game(std::array<Agent *, 3> _agents, bool _quiet = false,
+       uint64_t seed = thread_random()(), bid_rule_t _rule = RULE_ROB)
+      : rng(seed), round(0), players(3, Hand()), agents(_agents),
+        landlord(-1), quiet(_quiet), rule(_rule) {}
+  // Deal with a seed taken from the generator of the game
   void init();
-  void run();
+  // Restart the generator from seed, then deal and decide the landlord
+  void init(uint64_t seed);
+
+  /**
+   * @brief Play until one player runs out of cards
+   *
+   * @return The index of the winner
+   */
+  int run();
+
+  int get_landlord() const { return landlord; }
+  int get_round() const { return round; }
+  // Seed, deal, bids and moves of the current game
+  const GameRecord &get_record() const { return record; }
 };
 
-#endif // GAME
\ No newline at end of file
+#endif // GAME
@@ -0,0 +1,226 @@
+#include "GameRecord.h"
+
+#include <bit>
+#include <cassert>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void GameRecord::clear() {
+  seed = 0;
+  hands[0] = hands[1] = hands[2] = 0;
+  landlord_cards = 0;
+  redeals = 0;
+  first_bidder = landlord = winner = -1;
+  rule = 0;
+  bids.clear();
+  moves.clear();
+}
+
+template <typename T>
+static void put(std::vector<std::byte> &out, size_t offset, T value) {
+  std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void RecordFormat::serialize(const GameRecord &record,
+                             std::vector<std::byte> &out) {
+  assert(record.bids.size() <= UINT16_MAX && record.moves.size() <= UINT16_MAX);
+  size_t start = out.size();
+  size_t size = record_size(record.bids.size(), record.moves.size());
+  // Padding is zero
+  out.resize(start + size, std::byte{0});
+
+  put<uint32_t>(out, start, size);
+  put<uint16_t>(out, start + 4, record.bids.size());
+  put<uint16_t>(out, start + 6, record.moves.size());
+  put<uint64_t>(out, start + 8, record.seed);
+  for (int i = 0; i < 3; i++) {
+    put<uint64_t>(out, start + 16 + 8 * i, record.hands[i]);
+  }
+  put<uint64_t>(out, start + 40, record.landlord_cards);
+  put<uint8_t>(out, start + 48, record.first_bidder);
+  put<uint8_t>(out, start + 49, record.landlord);
+  put<uint8_t>(out, start + 50, record.winner);
+  put<uint8_t>(out, start + 51, record.rule);
+  put<uint32_t>(out, start + 52, record.redeals);
+
+  size_t offset = start + HEADER_SIZE;
+  for (auto bid : record.bids) {
+    put<uint8_t>(out, offset++, bid);
+  }
+  offset = start + HEADER_SIZE + bids_size(record.bids.size());
+  for (const auto &m : record.moves) {
+    put<uint32_t>(out, offset, m.encode());
+    offset += 4;
+  }
+}
+
+Move RecordFormat::decode_move(uint32_t code, uint32_t version) {
+  Move move = Move::decode(code);
+  int kicker_num = std::popcount(move.kickers);
+  if (version == 1 && move.type == Airplane_Single &&
+      kicker_num < move.length) {
+    move.pairs = (1 << kicker_num) - 1;
+  }
+  return move;
+}
+
+RecordWriter::RecordWriter(const std::string &_path, size_t buffer_size)
+    : file(std::fopen(_path.c_str(), "wb")), capacity(buffer_size),
+      path(_path) {
+  if (!file) {
+    throw std::runtime_error("Can not open " + path);
+  }
+  buffer.reserve(capacity);
+  spare.reserve(capacity);
+  buffer.resize(RecordFormat::FILE_HEADER_SIZE);
+  std::memcpy(buffer.data(), RecordFormat::MAGIC, 4);
+  std::memcpy(buffer.data() + 4, &RecordFormat::VERSION, 4);
+}
+
+RecordWriter::~RecordWriter() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+  }
+}
+
+void RecordWriter::write_spare() {
+  if (error.empty() &&
+      std::fwrite(spare.data(), 1, spare.size(), file) != spare.size()) {
+    error = "Can not write " + path;
+  }
+  spare.clear();
+}
+
+void RecordWriter::write(const GameRecord &record) {
+  // Each thread keeps its own scratch buffer, so that serializing needs
+  // neither the lock nor an allocation
+  thread_local std::vector<std::byte> local;
+  local.clear();
+  RecordFormat::serialize(record, local);
+
+  std::unique_lock<std::mutex> guard(lock);
+  assert(file && "Write after close");
+  if (buffer.size() + local.size() > capacity) {
+    // Taken before the buffer lock is released, so that the swaps are
+    // written in order
+    std::lock_guard<std::mutex> file_guard(file_lock);
+    buffer.swap(spare);
+    buffer.insert(buffer.end(), local.begin(), local.end());
+    guard.unlock();
+    write_spare();
+    return;
+  }
+  buffer.insert(buffer.end(), local.begin(), local.end());
+}
+
+void RecordWriter::flush() {
+  std::unique_lock<std::mutex> guard(lock);
+  if (!file) {
+    return;
+  }
+  std::lock_guard<std::mutex> file_guard(file_lock);
+  buffer.swap(spare);
+  guard.unlock();
+  write_spare();
+  if (std::fflush(file) != 0 && error.empty()) {
+    error = "Can not write " + path;
+  }
+}
+
+void RecordWriter::close() {
+  flush();
+  std::lock_guard<std::mutex> guard(lock);
+  std::lock_guard<std::mutex> file_guard(file_lock);
+  if (file && std::fclose(file) != 0 && error.empty()) {
+    error = "Can not close " + path;
+  }
+  file = nullptr;
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
+
+GameRecord RecordReader::RecordView::to_record() const {
+  GameRecord record;
+  to_record(record);
+  return record;
+}
+
+void RecordReader::RecordView::to_record(GameRecord &record) const {
+  record.clear();
+  record.seed = seed();
+  for (int i = 0; i < 3; i++) {
+    record.hands[i] = hand(i);
+  }
+  record.landlord_cards = landlord_cards();
+  record.redeals = redeals();
+  record.first_bidder = first_bidder();
+  record.landlord = landlord();
+  record.winner = winner();
+  record.rule = rule();
+  for (int i = 0; i < bid_num(); i++) {
+    record.bids.push_back(bid(i));
+  }
+  for (int i = 0; i < move_num(); i++) {
+    record.moves.push_back(move(i));
+  }
+}
+
+void RecordReader::iterator::check() const {
+  if (p == end) {
+    return;
+  }
+  size_t left = end - p;
+  if (left < RecordFormat::HEADER_SIZE) {
+    throw std::runtime_error("Truncated record header");
+  }
+  RecordView view(p, version);
+  size_t size = view.size();
+  // A size of 0 would never move to the next record
+  if (size < RecordFormat::HEADER_SIZE || size > left) {
+    throw std::runtime_error("Bad record size " + std::to_string(size) +
+                             ", " + std::to_string(left) + " bytes left");
+  }
+  if (size != RecordFormat::record_size(view.bid_num(), view.move_num())) {
+    throw std::runtime_error("Record size " + std::to_string(size) +
+                             " does not match its bids and moves");
+  }
+}
+
+RecordReader::RecordReader(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Can not open " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0 ||
+      (size_t)st.st_size < RecordFormat::FILE_HEADER_SIZE) {
+    close(fd);
+    throw std::runtime_error(path + " is not a record file");
+  }
+  length = st.st_size;
+  void *p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the file is closed
+  close(fd);
+  if (p == MAP_FAILED) {
+    throw std::runtime_error("Can not map " + path);
+  }
+  // Records are read once, in order
+  madvise(p, length, MADV_SEQUENTIAL);
+  data = (const std::byte *)p;
+
+  std::memcpy(&version, data + 4, 4);
+  if (std::memcmp(data, RecordFormat::MAGIC, 4) != 0 ||
+      version < RecordFormat::MIN_VERSION ||
+      version > RecordFormat::VERSION) {
+    munmap(p, length);
+    throw std::runtime_error(path + " is not a record file of version " +
+                             std::to_string(RecordFormat::VERSION));
+  }
+}
+
+RecordReader::~RecordReader() { munmap((void *)data, length); }
@@ -0,0 +1,254 @@
+#ifndef GAME_RECORD
+#define GAME_RECORD
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Move.h"
+
+/**
+ * @brief Everything needed to replay one game.
+ *
+ * The cards are 54-bit masks in the layout of Hand::get_cards(). moves has
+ * one entry per turn in order, starting with the landlord, passes included
+ * (as Move::none()).
+ */
+struct GameRecord {
+  // Game::init(seed) with this seed gives the same deal
+  uint64_t seed = 0;
+  // Hands before the landlord takes the landlord cards
+  uint64_t hands[3] = {0, 0, 0};
+  uint64_t landlord_cards = 0;
+  // Deals thrown away because nobody wanted to be the landlord
+  uint32_t redeals = 0;
+  // First bidder of the deal that was played
+  int first_bidder = -1;
+  int landlord = -1;
+  int winner = -1;
+  // The bid_rule_t of the auction, RULE_ROB by default
+  int rule = 0;
+  // Every decide_bid answer, of all the deals, in order
+  std::vector<uint8_t> bids;
+  std::vector<Move> moves;
+
+  void clear();
+};
+
+/**
+ * @brief Binary file of game records.
+ *
+ * The file starts with the magic "DDZR" and a 32-bit version. Every record
+ * is then, in native byte order and padded to 8 bytes:
+ *
+ *   offset  size  field
+ *        0     4  record size in bytes, padding included
+ *        4     2  number of bids
+ *        6     2  number of moves
+ *        8     8  seed
+ *       16    24  the 3 hands
+ *       40     8  landlord cards
+ *       48     1  first bidder
+ *       49     1  landlord
+ *       50     1  winner
+ *       51     1  bid rule
+ *       52     4  redeals
+ *       56        bids, 1 byte each, padded to 4 bytes
+ *                 moves, Move::encode() on 4 bytes each
+ */
+namespace RecordFormat {
+
+constexpr char MAGIC[4] = {'D', 'D', 'Z', 'R'};
+// 2 added the pairs of the single wings of airplanes to Move::encode().
+// Version 1 is still read, see decode_move
+constexpr uint32_t VERSION = 2;
+constexpr uint32_t MIN_VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr size_t HEADER_SIZE = 56;
+
+constexpr size_t bids_size(size_t bid_num) { return (bid_num + 3) & ~3; }
+constexpr size_t record_size(size_t bid_num, size_t move_num) {
+  return (HEADER_SIZE + bids_size(bid_num) + 4 * move_num + 7) & ~7;
+}
+
+// Append the record to out
+void serialize(const GameRecord &record, std::vector<std::byte> &out);
+
+/**
+ * @brief A move of a file of the given version
+ *
+ * In version 1, an Airplane_Single with fewer kicker ranks than triples took
+ * two cards of every kicker rank.
+ */
+Move decode_move(uint32_t code, uint32_t version);
+
+} // namespace RecordFormat
+
+/**
+ * @brief Append records to a file from any number of threads.
+ *
+ * A record is serialized by the calling thread without any lock, then copied
+ * into a shared buffer under a mutex. When the buffer is full, it is swapped
+ * with an empty one and written to the file after the buffer lock is
+ * released, so the other threads go on filling the new buffer during the
+ * write. Most calls do not touch the file.
+ *
+ * A failed write is remembered, and close() throws it.
+ */
+class RecordWriter {
+private:
+  std::FILE *file;
+  // Taken before file_lock when both are needed
+  std::mutex lock;
+  std::vector<std::byte> buffer;
+  size_t capacity;
+
+  // Keeps the writes in the order of the swaps
+  std::mutex file_lock;
+  // The buffer being written, under file_lock
+  std::vector<std::byte> spare;
+  std::string path;
+  std::string error;
+
+  // Called with file_lock held
+  void write_spare();
+
+public:
+  static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+  // Create (or truncate) the file, throws std::runtime_error on failure
+  explicit RecordWriter(const std::string &_path,
+                        size_t buffer_size = DEFAULT_BUFFER_SIZE);
+  RecordWriter(const RecordWriter &) = delete;
+  RecordWriter &operator=(const RecordWriter &) = delete;
+  // Same as close(), without throwing
+  ~RecordWriter();
+
+  void write(const GameRecord &record);
+  void flush();
+  /**
+   * @brief Flush and close the file, throws std::runtime_error if some
+   * records could not be written
+   */
+  void close();
+};
+
+/**
+ * @brief Read-only view of a record file mapped in memory.
+ *
+ * Records are read in place: iterating creates no object on the heap, and
+ * only the fields asked for are read.
+ */
+class RecordReader {
+public:
+  class RecordView {
+  private:
+    const std::byte *data;
+    uint32_t version;
+
+    template <typename T> T read(size_t offset) const {
+      T value;
+      std::memcpy(&value, data + offset, sizeof(T));
+      return value;
+    }
+
+  public:
+    RecordView(const std::byte *_data, uint32_t _version)
+        : data(_data), version(_version) {}
+
+    uint32_t size() const { return read<uint32_t>(0); }
+    int bid_num() const { return read<uint16_t>(4); }
+    int move_num() const { return read<uint16_t>(6); }
+    uint64_t seed() const { return read<uint64_t>(8); }
+    uint64_t hand(int player) const { return read<uint64_t>(16 + 8 * player); }
+    uint64_t landlord_cards() const { return read<uint64_t>(40); }
+    int first_bidder() const { return (int)data[48]; }
+    int landlord() const { return (int)data[49]; }
+    int winner() const { return (int)data[50]; }
+    int rule() const { return (int)data[51]; }
+    uint32_t redeals() const { return read<uint32_t>(52); }
+    int bid(int i) const { return (int)data[RecordFormat::HEADER_SIZE + i]; }
+    Move move(int i) const {
+      return RecordFormat::decode_move(
+          read<uint32_t>(RecordFormat::HEADER_SIZE +
+                         RecordFormat::bids_size(bid_num()) + 4 * i),
+          version);
+    }
+
+    // Copy everything into a GameRecord
+    GameRecord to_record() const;
+    // The same into record, reusing the memory of its vectors
+    void to_record(GameRecord &record) const;
+  };
+
+  /**
+   * @brief Walks the records, checking the size and the counts of each one
+   * against the end of the file before it can be read
+   *
+   * Throws std::runtime_error at the first record that is truncated or
+   * corrupt, instead of reading past the mapping.
+   */
+  class iterator {
+  private:
+    const std::byte *p;
+    const std::byte *end;
+    uint32_t version;
+
+    // Check the record at p, unless p is the end
+    void check() const;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = RecordView;
+    using reference = RecordView;
+    using pointer = void;
+
+    iterator() : p(nullptr), end(nullptr), version(RecordFormat::VERSION) {}
+    iterator(const std::byte *_p, const std::byte *_end, uint32_t _version)
+        : p(_p), end(_end), version(_version) {
+      check();
+    }
+
+    RecordView operator*() const { return RecordView(p, version); }
+    iterator &operator++() {
+      p += RecordView(p, version).size();
+      check();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator it = *this;
+      ++*this;
+      return it;
+    }
+    friend bool operator==(const iterator &i1, const iterator &i2) = default;
+  };
+
+private:
+  const std::byte *data;
+  size_t length;
+  uint32_t version;
+
+public:
+  // Map the file, throws std::runtime_error if it can not be read or is not
+  // a record file of this version. The records are checked by the iterator
+  explicit RecordReader(const std::string &path);
+  RecordReader(const RecordReader &) = delete;
+  RecordReader &operator=(const RecordReader &) = delete;
+  ~RecordReader();
+
+  iterator begin() const {
+    return iterator(data + RecordFormat::FILE_HEADER_SIZE, data + length,
+                    version);
+  }
+  iterator end() const {
+    return iterator(data + length, data + length, version);
+  }
+};
+
+#endif // GAME_RECORD
@@ -0,0 +1,67 @@
+#include "GameState.h"
+
+#include "Zobrist.h"
+
+GameState::GameState(const Hand (&_hands)[3], int _landlord)
+    : GameState(_hands, _landlord, _landlord, Move::none(), -1) {}
+
+GameState::GameState(const Hand (&_hands)[3], int _landlord, int _turn,
+                     const Move &_last_play, int _last_player)
+    : hands{_hands[0], _hands[1], _hands[2]}, landlord(_landlord),
+      turn(_turn), last_play(_last_play), last_player(_last_player) {
+  hash = compute_hash();
+}
+
+uint64_t GameState::compute_hash() const {
+  uint64_t z = Zobrist::LANDLORD[landlord] ^ Zobrist::TURN[turn] ^
+               Zobrist::LAST_PLAYER[last_player + 1] ^
+               Zobrist::last_play(last_play);
+  for (int i = 0; i < 3; i++) {
+    z ^= Zobrist::hand(i, hands[i]);
+  }
+  return z;
+}
+
+int GameState::winner() const {
+  for (int i = 0; i < 3; i++) {
+    if (hands[i].empty()) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+GameState::Undo GameState::make_move(const Move &move) {
+  Undo undo{move, 0, hash, last_play, (int8_t)turn, (int8_t)last_player};
+  // Everything that changes is XORed out here and back in at the end
+  hash ^= Zobrist::TURN[turn] ^ Zobrist::LAST_PLAYER[last_player + 1] ^
+          Zobrist::last_play(last_play);
+  if (move.is_none()) {
+    assert(can_pass() && "The first one can not give up");
+  } else {
+    assert(move.beats(last_play));
+    hash ^= Zobrist::remove(turn, hands[turn], move);
+    undo.cards = hands[turn].remove(move);
+    last_play = move;
+    last_player = turn;
+  }
+  turn = (turn + 1) % 3;
+  // Everyone else passed, the last player wins this round and leads
+  if (turn == last_player) {
+    last_play = Move::none();
+    last_player = -1;
+  }
+  hash ^= Zobrist::TURN[turn] ^ Zobrist::LAST_PLAYER[last_player + 1] ^
+          Zobrist::last_play(last_play);
+  return undo;
+}
+
+void GameState::unmake_move(const Undo &undo) {
+  turn = undo.turn;
+  if (!undo.move.is_none()) {
+    hands[turn].restore(undo.move, undo.cards);
+  }
+  last_play = undo.last_play;
+  last_player = undo.last_player;
+  hash = undo.hash;
+}
@@ -0,0 +1,74 @@
+#ifndef GAME_STATE
+#define GAME_STATE
+
+#include <cstdint>
+
+#include "Hand.h"
+#include "Move.h"
+
+/**
+ * @brief A position during the play, after the landlord is decided.
+ *
+ * Everything is visible here (all three hands), so it is meant for search
+ * and simulation, not to be shown to a player.
+ */
+struct GameState {
+  Hand hands[3];
+  int landlord;
+  // The player to move
+  int turn;
+  // Move::none() if turn leads the round
+  Move last_play;
+  // Who played last_play, -1 if turn leads the round
+  int last_player;
+  // Zobrist hash of everything above, the landlord included, kept up to date
+  // by make_move(), see Zobrist.h
+  uint64_t hash;
+
+  GameState() = default;
+  // The start of the play: the landlord leads
+  GameState(const Hand (&_hands)[3], int _landlord);
+  // A position in the middle of the play
+  GameState(const Hand (&_hands)[3], int _landlord, int _turn,
+            const Move &_last_play, int _last_player);
+
+  bool is_landlord(int player) const { return player == landlord; }
+  bool same_side(int p1, int p2) const {
+    return is_landlord(p1) == is_landlord(p2);
+  }
+
+  bool is_over() const {
+    return hands[0].empty() || hands[1].empty() || hands[2].empty();
+  }
+  // The player who ran out of cards, -1 if the game is not over
+  int winner() const;
+
+  // The hash computed from scratch, equal to hash
+  uint64_t compute_hash() const;
+
+  // The player to move can pass
+  bool can_pass() const { return !last_play.is_none(); }
+
+  // Everything make_move changes, to undo it
+  struct Undo {
+    Move move;
+    // The cards taken from the hand of the player
+    uint64_t cards;
+    uint64_t hash;
+    Move last_play;
+    int8_t turn;
+    int8_t last_player;
+  };
+
+  /**
+   * @brief Play the move (Move::none() to pass) for the player to move and
+   * give the turn to the next player
+   *
+   * @return What unmake_move needs to go back to this position
+   */
+  Undo make_move(const Move &move);
+  // Undo the make_move that returned undo, in O(1)
+  void unmake_move(const Undo &undo);
+};
+
+#endif // GAME_STATE
@@ -0,0 +1,146 @@
+#ifndef GENERATOR
+#define GENERATOR
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "Profile.h"
+
+/**
+ * @brief Lazy range of values produced by a coroutine with co_yield.
+ *
+ * Nothing is computed until the range is iterated, and the coroutine only
+ * runs until the next co_yield, so that the caller can stop at any time.
+ * Yielded values are only valid until the iterator is incremented.
+ *
+ * A coroutine whose first two parameters are (std::allocator_arg_t,
+ * std::pmr::memory_resource *) puts its frame in that memory resource
+ * instead of the global heap.
+ */
+template <typename T> class Generator {
+public:
+  struct promise_type {
+    const T *value = nullptr;
+    std::exception_ptr exception;
+
+    Generator get_return_object() {
+      return Generator(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    // The yielded temporary lives until the coroutine is resumed
+    std::suspend_always yield_value(const T &v) noexcept {
+      value = std::addressof(v);
+      return {};
+    }
+    void return_void() {}
+    void unhandled_exception() { exception = std::current_exception(); }
+
+    // The memory resource (or nullptr for the global heap) is stored after
+    // the frame, so that operator delete knows where the frame comes from
+    static size_t header_offset(size_t size) {
+      return (size + alignof(std::pmr::memory_resource *) - 1) &
+             ~(alignof(std::pmr::memory_resource *) - 1);
+    }
+    static size_t total_size(size_t size) {
+      return header_offset(size) + sizeof(std::pmr::memory_resource *);
+    }
+
+    static void *operator new(size_t size) {
+      Profile::count_allocation();
+      void *p = ::operator new(total_size(size));
+      new ((std::byte *)p + header_offset(size))
+          std::pmr::memory_resource *(nullptr);
+      return p;
+    }
+    template <typename... Args>
+    static void *operator new(size_t size, std::allocator_arg_t,
+                              std::pmr::memory_resource *resource,
+                              Args &&...) {
+      Profile::count_allocation(resource);
+      void *p = resource->allocate(total_size(size),
+                                   alignof(std::max_align_t));
+      new ((std::byte *)p + header_offset(size))
+          std::pmr::memory_resource *(resource);
+      return p;
+    }
+    static void operator delete(void *p, size_t size) {
+      auto resource = *std::launder(
+          (std::pmr::memory_resource **)((std::byte *)p + header_offset(size)));
+      if (resource) {
+        resource->deallocate(p, total_size(size), alignof(std::max_align_t));
+      } else {
+        ::operator delete(p);
+      }
+    }
+  };
+
+  using handle_type = std::coroutine_handle<promise_type>;
+
+  class iterator {
+  private:
+    handle_type handle;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using reference = const T &;
+    using pointer = const T *;
+
+    iterator() = default;
+    explicit iterator(handle_type _handle) : handle(_handle) {}
+
+    reference operator*() const { return *handle.promise().value; }
+    pointer operator->() const { return handle.promise().value; }
+
+    iterator &operator++() {
+      handle.resume();
+      if (handle.done() && handle.promise().exception) {
+        std::rethrow_exception(handle.promise().exception);
+      }
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator &it, std::default_sentinel_t) {
+      return !it.handle || it.handle.done();
+    }
+  };
+
+private:
+  handle_type handle;
+
+  explicit Generator(handle_type _handle) : handle(_handle) {}
+
+public:
+  Generator(const Generator &) = delete;
+  Generator &operator=(const Generator &) = delete;
+  Generator(Generator &&g) noexcept : handle(std::exchange(g.handle, {})) {}
+  Generator &operator=(Generator &&g) noexcept {
+    std::swap(handle, g.handle);
+    return *this;
+  }
+  ~Generator() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  // Can be called only once
+  iterator begin() {
+    iterator it(handle);
+    ++it;
+    return it;
+  }
+  std::default_sentinel_t end() { return {}; }
+};
+
+#endif // GENERATOR
@@ -0,0 +1,119 @@
+#include "Hand.h"
+
+#include "Profile.h"
+
+namespace {
+
+// Card ids of the 4 suits of number 1, shifted by (number - 1) for the others
+constexpr uint64_t SUIT_STRIDE = 1ULL | 1ULL << 13 | 1ULL << 26 | 1ULL << 39;
+
+constexpr uint64_t make_rank_card_mask(int rank) {
+  if (rank == Hand::RANK_BLACK_JOKER)
+    return 1ULL << 52;
+  if (rank == Hand::RANK_RED_JOKER)
+    return 1ULL << 53;
+  int number = rank < 11 ? rank + 3 : rank - 10;
+  return SUIT_STRIDE << (number - 1);
+}
+
+constexpr uint64_t RANK_CARD_MASK[Hand::RANK_NUM] = {
+    make_rank_card_mask(0),  make_rank_card_mask(1),  make_rank_card_mask(2),
+    make_rank_card_mask(3),  make_rank_card_mask(4),  make_rank_card_mask(5),
+    make_rank_card_mask(6),  make_rank_card_mask(7),  make_rank_card_mask(8),
+    make_rank_card_mask(9),  make_rank_card_mask(10), make_rank_card_mask(11),
+    make_rank_card_mask(12), make_rank_card_mask(13), make_rank_card_mask(14),
+};
+
+} // namespace
+
+Hand::Hand(const std::vector<Card> &hand) : Hand() {
+  for (const auto &c : hand) {
+    add(c);
+  }
+}
+
+Hand Hand::from_cards(uint64_t cards) {
+  assert(cards >> 54 == 0 && "Card mask out of bound");
+  Hand h;
+  h.cards = cards;
+  for (int r = 0; r < RANK_NUM; r++) {
+    h.counts |= (uint64_t)std::popcount(cards & RANK_CARD_MASK[r]) << (4 * r);
+  }
+  return h;
+}
+
+void Hand::add(const Card &c) {
+  assert(!contains(c) && "Card is already in the hand");
+  cards |= 1ULL << c.get_id();
+  counts += 1ULL << (4 * c.get_rank());
+}
+
+void Hand::remove(const Card &c) {
+  assert(contains(c) && "Card is not in the hand");
+  cards &= ~(1ULL << c.get_id());
+  counts -= 1ULL << (4 * c.get_rank());
+}
+
+uint64_t Hand::select(const Move &move) const {
+  uint64_t ans = 0;
+  uint64_t move_counts = move.counts();
+  while (move_counts) {
+    int rank = std::countr_zero(move_counts) / 4;
+    int n = (move_counts >> (4 * rank)) & 0xF;
+    move_counts &= ~(0xFULL << (4 * rank));
+    assert(count(rank) >= n && "Not enough cards for the move");
+    uint64_t mask = cards & RANK_CARD_MASK[rank];
+    for (int i = 0; i < n; i++) {
+      ans |= mask & -mask;
+      mask &= mask - 1;
+    }
+  }
+  return ans;
+}
+
+uint64_t Hand::remove(const Move &move) {
+  Profile::Scope scope(Profile::REMOVE);
+  uint64_t removed = select(move);
+  cards &= ~removed;
+  counts -= move.counts();
+  return removed;
+}
+
+uint16_t Hand::ranks_with_at_least(uint64_t counts, int n) {
+  assert(n >= 1 && n <= 4);
+  // A counter c in [0, 4] plus (8 - n) never carries into the next counter,
+  // and reaches 8 exactly when c >= n
+  uint64_t x = ((counts + NIBBLE_LOW * (8 - n)) >> 3) & NIBBLE_LOW;
+  // Gather the lowest bit of every counter into the low 15 bits
+  x = (x | x >> 3) & 0x0303030303030303ULL;
+  x = (x | x >> 6) & 0x000F000F000F000FULL;
+  x = (x | x >> 12) & 0x000000FF000000FFULL;
+  x = (x | x >> 24) & 0xFFFFULL;
+  return (uint16_t)x;
+}
+
+uint64_t Hand::rank_card_mask(int rank) {
+  assert(rank >= 0 && rank < RANK_NUM);
+  return RANK_CARD_MASK[rank];
+}
+
+std::vector<Card> Hand::take(int rank, int n) const {
+  assert(count(rank) >= n);
+  std::vector<Card> ans;
+  uint64_t mask = cards & RANK_CARD_MASK[rank];
+  for (int i = 0; i < n; i++) {
+    ans.push_back(Card(std::countr_zero(mask)));
+    mask &= mask - 1;
+  }
+  return ans;
+}
+
+std::vector<Card> Hand::to_vector() const {
+  Profile::Scope scope(Profile::SORT);
+  std::vector<Card> ans;
+  for (int r = 0; r < RANK_NUM; r++) {
+    std::vector<Card> same_rank = take(r, count(r));
+    ans.insert(ans.end(), same_rank.begin(), same_rank.end());
+  }
+  return ans;
+}
@@ -0,0 +1,99 @@
+#ifndef HAND
+#define HAND
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "Card.h"
+#include "Move.h"
+
+/**
+ * @brief Compact representation of the cards held by a player.
+ *
+ * The number of cards of each rank (see Card::get_rank) is packed into one
+ * 64-bit word, 4 bits per rank, so that most queries needed by move
+ * generation are a few shifts and masks. The concrete cards are kept in a
+ * second word, one bit per card id (see Card::get_id), to know which suits
+ * to play.
+ */
+class Hand {
+private:
+  // Bits [4 * r, 4 * r + 4) hold the number of cards of rank r
+  uint64_t counts;
+  // Bit i is set if Card(i) is in the hand
+  uint64_t cards;
+
+public:
+  static constexpr int RANK_NUM = 15;
+  static constexpr int RANK_TWO = 12;
+  static constexpr int RANK_BLACK_JOKER = 13;
+  static constexpr int RANK_RED_JOKER = 14;
+
+  // 1 in the lowest bit of each of the 15 rank counters
+  static constexpr uint64_t NIBBLE_LOW = 0x0111111111111111ULL;
+
+  Hand() : counts(0), cards(0) {}
+  explicit Hand(const std::vector<Card> &hand);
+
+  // Build from a card mask, in the same layout as get_cards()
+  static Hand from_cards(uint64_t cards);
+
+  void add(const Card &c);
+  void remove(const Card &c);
+
+  /**
+   * @brief Cards played by the move from this hand, lowest suit first
+   *
+   * @return Card mask in the same layout as get_cards()
+   */
+  uint64_t select(const Move &move) const;
+  /**
+   * @brief Remove the cards chosen by select(move)
+   *
+   * @return The removed cards, to give to restore()
+   */
+  uint64_t remove(const Move &move);
+  // Put back the cards removed by remove(move)
+  void restore(const Move &move, uint64_t removed) {
+    cards |= removed;
+    counts += move.counts();
+  }
+  bool contains(const Card &c) const { return cards >> c.get_id() & 1; }
+
+  int count(int rank) const { return (counts >> (4 * rank)) & 0xF; }
+  int size() const { return std::popcount(cards); }
+  bool empty() const { return cards == 0; }
+
+  uint64_t get_counts() const { return counts; }
+  uint64_t get_cards() const { return cards; }
+
+  /**
+   * @brief Ranks of which the hand has at least n cards
+   *
+   * @param n In range [1, 4]
+   * @return Bit r is set if count(r) >= n
+   */
+  uint16_t ranks_with_at_least(int n) const {
+    return ranks_with_at_least(counts, n);
+  }
+  // The same from counts in the layout of get_counts()
+  static uint16_t ranks_with_at_least(uint64_t counts, int n);
+
+  // Card ids of rank r, in the same layout as get_cards()
+  static uint64_t rank_card_mask(int rank);
+
+  /**
+   * @brief Pick n cards of the given rank, lowest suit first
+   */
+  std::vector<Card> take(int rank, int n) const;
+
+  // All cards, sorted by rank
+  std::vector<Card> to_vector() const;
+
+  friend bool operator==(const Hand &h1, const Hand &h2) {
+    return h1.cards == h2.cards;
+  }
+};
+
+#endif // HAND
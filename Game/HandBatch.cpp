@@ -0,0 +1,122 @@
+#include "HandBatch.h"
+
+#include "Sequence.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAND_BATCH_X86
+#endif
+
+namespace {
+
+const uint16_t JOKERS = 1 << Hand::RANK_BLACK_JOKER | 1 << Hand::RANK_RED_JOKER;
+
+} // namespace
+
+void HandBatch::resize(size_t size) {
+  counts.resize(size);
+  for (auto &v : at_least_masks) {
+    v.resize(size);
+  }
+  for (auto &v : sequence_masks) {
+    v.resize(size);
+  }
+  rockets.resize(size);
+}
+
+void HandBatch::compute() {
+  if (has_avx2()) {
+    compute_avx2();
+  } else {
+    compute_scalar();
+  }
+}
+
+void HandBatch::compute_scalar() {
+  for (size_t i = 0; i < size(); i++) {
+    for (int n = 1; n <= 4; n++) {
+      at_least_masks[n - 1][i] = Hand::ranks_with_at_least(counts[i], n);
+    }
+    for (int m = 1; m <= 3; m++) {
+      sequence_masks[m - 1][i] =
+          Sequence::window_starts(at_least_masks[m - 1][i],
+                                  Sequence::MIN_LENGTH[m]);
+    }
+    rockets[i] = (at_least_masks[0][i] & JOKERS) == JOKERS;
+  }
+}
+
+#ifdef HAND_BATCH_X86
+
+bool HandBatch::has_avx2() {
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return avx2;
+}
+
+__attribute__((target("avx2"))) void HandBatch::compute_avx2() {
+  size_t n = size();
+  size_t i = 0;
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  for (; i + 2 <= n; i += 2) {
+    // Byte k of the counts holds ranks 2k (low nibble) and 2k + 1
+    __m128i v = _mm_loadu_si128((const __m128i *)&counts[i]);
+    __m128i low = _mm_and_si128(v, nibble);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    // One byte per rank, hand i in the low lane and hand i + 1 in the high
+    __m256i rows = _mm256_set_m128i(_mm_unpackhi_epi8(low, high),
+                                    _mm_unpacklo_epi8(low, high));
+    for (int k = 1; k <= 4; k++) {
+      uint32_t mask = _mm256_movemask_epi8(
+          _mm256_cmpgt_epi8(rows, _mm256_set1_epi8((char)(k - 1))));
+      at_least_masks[k - 1][i] = mask & 0x7FFF;
+      at_least_masks[k - 1][i + 1] = (mask >> 16) & 0x7FFF;
+    }
+  }
+  for (; i < n; i++) {
+    for (int k = 1; k <= 4; k++) {
+      at_least_masks[k - 1][i] = Hand::ranks_with_at_least(counts[i], k);
+    }
+  }
+
+  // 16 hands at once, one 16-bit lane each
+  const __m256i ranks = _mm256_set1_epi16(Sequence::RANKS);
+  const __m256i jokers = _mm256_set1_epi16(JOKERS);
+  for (i = 0; i + 16 <= n; i += 16) {
+    for (int m = 1; m <= 3; m++) {
+      __m256i a = _mm256_and_si256(
+          _mm256_loadu_si256((const __m256i *)&at_least_masks[m - 1][i]),
+          ranks);
+      __m256i starts = a;
+      for (int j = 1; j < Sequence::MIN_LENGTH[m]; j++) {
+        starts = _mm256_and_si256(
+            starts, _mm256_srl_epi16(a, _mm_cvtsi32_si128(j)));
+      }
+      _mm256_storeu_si256((__m256i *)&sequence_masks[m - 1][i], starts);
+    }
+    __m256i singles =
+        _mm256_loadu_si256((const __m256i *)&at_least_masks[0][i]);
+    __m256i rocket = _mm256_cmpeq_epi16(_mm256_and_si256(singles, jokers),
+                                        jokers);
+    // 0xFFFF or 0 per hand, narrowed to 1 or 0 per byte
+    __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(rocket),
+                                     _mm256_extracti128_si256(rocket, 1));
+    _mm_storeu_si128((__m128i *)&rockets[i],
+                     _mm_and_si128(packed, _mm_set1_epi8(1)));
+  }
+  for (; i < n; i++) {
+    for (int m = 1; m <= 3; m++) {
+      sequence_masks[m - 1][i] =
+          Sequence::window_starts(at_least_masks[m - 1][i],
+                                  Sequence::MIN_LENGTH[m]);
+    }
+    rockets[i] = (at_least_masks[0][i] & JOKERS) == JOKERS;
+  }
+}
+
+#else
+
+bool HandBatch::has_avx2() { return false; }
+
+void HandBatch::compute_avx2() { compute_scalar(); }
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef HAND_BATCH
+#define HAND_BATCH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Hand.h"
+
+/**
+ * @brief The masks move generation starts from, for many hands at once.
+ *
+ * Every result is an array with one entry per hand (structure of arrays), so
+ * that each step of compute() runs over contiguous memory:
+ * - at_least(n): ranks of which the hand has at least n cards, n in [1, 4]
+ *   (singles, pairs, triples, bombs), as Hand::ranks_with_at_least;
+ * - sequence(m): start ranks of the sequences of multiplicity m in [1, 3]
+ *   with the minimum length (5 singles, 3 pairs, 2 triples), as
+ *   Strategy does. A longer sequence contains one of them;
+ * - rocket: whether the hand has both jokers.
+ *
+ * With AVX2, the rank counts of two hands are spread into 16-byte rows (one
+ * byte per rank) in one 256-bit register, compared with n - 1 and reduced to
+ * bit masks with movemask. The sequences are then computed for 16 hands at
+ * once. Without AVX2 (checked at run time) the same is done one hand at a
+ * time.
+ */
+class HandBatch {
+private:
+  std::vector<uint64_t> counts;
+  std::vector<uint16_t> at_least_masks[4];
+  std::vector<uint16_t> sequence_masks[3];
+  std::vector<uint8_t> rockets;
+
+  void compute_avx2();
+
+public:
+  explicit HandBatch(size_t size = 0) { resize(size); }
+
+  size_t size() const { return counts.size(); }
+  void resize(size_t size);
+  void set(size_t i, const Hand &hand) { counts[i] = hand.get_counts(); }
+
+  // Compute all the masks, with AVX2 if the CPU has it
+  void compute();
+  // Compute without SIMD, also used when the CPU has no AVX2
+  void compute_scalar();
+  static bool has_avx2();
+
+  uint16_t at_least(size_t i, int n) const { return at_least_masks[n - 1][i]; }
+  uint16_t sequence(size_t i, int m) const { return sequence_masks[m - 1][i]; }
+  bool rocket(size_t i) const { return rockets[i]; }
+};
+
+#endif // HAND_BATCH
@@ -0,0 +1,163 @@
+#include "MctsAgent.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Bidding.h"
+#include "Strategy.h"
+
+MctsAgent::MctsAgent(uint64_t seed, Budget _budget, int thread_num)
+    : gen(seed), budget(_budget), pool(thread_num) {
+  assert((budget.iterations > 0 || budget.milliseconds > 0) &&
+         "The search needs a limit");
+  for (int i = 0; i < thread_num; i++) {
+    workers.push_back(std::make_unique<Worker>());
+  }
+}
+
+int MctsAgent::decide_bid(const BidView &view) {
+  return Bidding::decide(view);
+}
+
+GameState MctsAgent::determinize(const MoveView &view, Random &rng) {
+  Hand hands[3];
+  view.belief.sample(rng, hands);
+  return GameState(hands, view.landlord, view.player, view.last_play,
+                   view.last_player);
+}
+
+int MctsAgent::playout(GameState &state, Random &rng, Arena &arena) {
+  while (!state.is_over()) {
+    arena.reset();
+    std::pmr::vector<Move> moves = Strategy::get_moves(
+        state.hands[state.turn], state.last_play, arena.get());
+    // Let the partner keep the round
+    if (state.can_pass() &&
+        (moves.empty() || state.same_side(state.last_player, state.turn) ||
+         rng.bounded(moves.size() + 1) == 0)) {
+      state.make_move(Move::none());
+    } else {
+      state.make_move(moves[rng.bounded(moves.size())]);
+    }
+  }
+  return state.winner();
+}
+
+void MctsAgent::search(Worker &worker, const MoveView &view,
+                       std::chrono::steady_clock::time_point deadline) {
+  auto &tree = worker.tree;
+  tree.clear();
+  tree.push_back({Move::none(), view.player, 0, 0, 0, {}});
+
+  std::vector<int> path;
+  for (int it = 0;; it++) {
+    if (budget.iterations > 0 && it >= budget.iterations) {
+      break;
+    }
+    if (budget.milliseconds > 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+
+    GameState state = determinize(view, worker.rng);
+    worker.arena.reset();
+    path.assign(1, 0);
+    int node = 0;
+    while (!state.is_over()) {
+      std::pmr::vector<Move> moves = Strategy::get_moves(
+          state.hands[state.turn], state.last_play, worker.arena.get());
+      if (state.can_pass()) {
+        moves.push_back(Move::none());
+      }
+
+      // Choose among the existing children that are legal here, unless a
+      // legal move has no child yet
+      std::pmr::vector<Move> untried(worker.arena.get());
+      int best = -1;
+      double best_value = -1;
+      const auto &children = tree[node].children;
+      for (const auto &m : moves) {
+        auto it = std::lower_bound(children.begin(), children.end(),
+                                   m.encode(), [&](int c, uint32_t code) {
+                                     return tree[c].move.encode() < code;
+                                   });
+        if (it == children.end() || tree[*it].move != m) {
+          untried.push_back(m);
+          continue;
+        }
+        Node &child = tree[*it];
+        child.available++;
+        double value = child.wins / child.visits +
+                       EXPLORATION * std::sqrt(std::log(child.available) /
+                                               child.visits);
+        if (value > best_value) {
+          best_value = value;
+          best = *it;
+        }
+      }
+
+      if (!untried.empty()) {
+        Move m = untried[worker.rng.bounded(untried.size())];
+        int child = tree.size();
+        tree.push_back({m, state.turn, 0, 1, 0, {}});
+        auto &list = tree[node].children;
+        list.insert(std::lower_bound(list.begin(), list.end(), m.encode(),
+                                     [&](int c, uint32_t code) {
+                                       return tree[c].move.encode() < code;
+                                     }),
+                    child);
+        state.make_move(m);
+        path.push_back(child);
+        break;
+      }
+      state.make_move(tree[best].move);
+      node = best;
+      path.push_back(node);
+    }
+
+    int winner = playout(state, worker.rng, worker.arena);
+    for (int n : path) {
+      tree[n].visits++;
+      if (state.same_side(winner, tree[n].player)) {
+        tree[n].wins++;
+      }
+    }
+  }
+}
+
+int MctsAgent::decide_move(const MoveView &view,
+                           std::span<const Move> moves) {
+  bool lead = view.last_play.is_none();
+  if (lead && moves.size() == 1) {
+    return 0;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double, std::milli>(
+                          budget.milliseconds));
+  for (auto &w : workers) {
+    w->rng = Random(gen());
+  }
+  pool.parallel_for(workers.size(), 1, [&](int, size_t i) {
+    search(*workers[i], view, deadline);
+  });
+
+  // Sum the visits of the same root move over all the trees, -1 is the pass
+  std::vector<int> visits(moves.size() + 1, 0);
+  for (const auto &w : workers) {
+    for (int c : w->tree[0].children) {
+      const Node &child = w->tree[c];
+      if (child.move.is_none()) {
+        visits[0] += child.visits;
+        continue;
+      }
+      auto it = std::find(moves.begin(), moves.end(), child.move);
+      assert(it != moves.end() && "The tree has an illegal root move");
+      visits[it - moves.begin() + 1] += child.visits;
+    }
+  }
+  int first = lead ? 1 : 0;
+  return std::max_element(visits.begin() + first, visits.end()) -
+         visits.begin() - 1;
+}
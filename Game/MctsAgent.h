@@ -0,0 +1,89 @@
+#ifndef MCTS_AGENT
+#define MCTS_AGENT
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Agent.h"
+#include "Arena.h"
+#include "GameState.h"
+#include "Random.h"
+#include "WorkStealingPool.h"
+
+/**
+ * @brief Information set Monte Carlo tree search (single observer ISMCTS).
+ *
+ * Every iteration deals the unseen cards at random to the two other players
+ * (a determinization drawn from the Belief of the player: consistent with
+ * the cards played, the hand sizes and the landlord cards, and with the
+ * guesses from passes), then walks down one shared tree of moves. Only the
+ * children that are legal in the current determinization are considered, and
+ * they are chosen with UCB1 where the number of visits of the parent is
+ * replaced by the number of times the child was available. A random playout
+ * finishes the game, and the result is counted for the side of the player
+ * who made each move.
+ *
+ * With several threads every thread grows its own tree (root parallelism),
+ * and the visits of the root children are summed to pick the move. The trees
+ * share nothing, so no virtual loss or lock is needed.
+ */
+class MctsAgent : public Agent {
+public:
+  struct Budget {
+    // Iterations per thread and per decision, 0 for no limit
+    int iterations;
+    // Time per decision, 0 for no limit
+    double milliseconds;
+  };
+
+private:
+  struct Node {
+    // The move leading to this node, and the player who made it
+    Move move;
+    int player;
+    int visits;
+    // Number of iterations where this node was a legal choice
+    int available;
+    // Iterations won by the side of player
+    double wins;
+    // Indices of the children, sorted by Move::encode
+    std::vector<int> children;
+  };
+
+  // What one thread needs to grow one tree
+  struct Worker {
+    Random rng;
+    Arena arena;
+    std::vector<Node> tree;
+
+    Worker() : rng(0) {}
+  };
+
+  Random gen;
+  Budget budget;
+  WorkStealingPool pool;
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  static GameState determinize(const MoveView &view, Random &rng);
+  // Play random moves until the end, return the winner
+  static int playout(GameState &state, Random &rng, Arena &arena);
+
+  void search(Worker &worker, const MoveView &view,
+              std::chrono::steady_clock::time_point deadline);
+
+public:
+  static constexpr double EXPLORATION = 0.7;
+
+  /**
+   * @param budget Stop when either limit is reached, one of them must be set
+   * @param thread_num Number of trees grown at the same time
+   */
+  MctsAgent(uint64_t seed, Budget _budget, int thread_num = 1);
+
+  int decide_bid(const BidView &view) override;
+  int decide_move(const MoveView &view,
+                  std::span<const Move> moves) override;
+};
+
+#endif // MCTS_AGENT
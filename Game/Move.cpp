@@ -0,0 +1,165 @@
+#include "Move.h"
+
+#include <bit>
+
+#include "Hand.h"
+
+Type Move::get_type() const {
+  switch (get_type_t()) {
+  case SingleSeq:
+  case DoubleSeq:
+  case ThreeSeq:
+  case Airplane_Single:
+  case Airplane_Pair:
+    return Type(get_type_t(), length);
+  default:
+    return Type(get_type_t());
+  }
+}
+
+int Move::multiplicity() const {
+  switch (get_type_t()) {
+  case Single:
+  case SingleSeq:
+  case UltraBomb:
+    return 1;
+  case Double:
+  case DoubleSeq:
+    return 2;
+  case Triple:
+  case ThreeSeq:
+  case ThreeOne:
+  case ThreeTwo:
+  case Airplane_Single:
+  case Airplane_Pair:
+    return 3;
+  case Four_Two_Single:
+  case Four_Two_Pair:
+  case Bomb:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+int Move::kicker_multiplicity() const {
+  switch (get_type_t()) {
+  case ThreeOne:
+  case Four_Two_Single:
+  case Airplane_Single:
+    return 1;
+  case ThreeTwo:
+  case Four_Two_Pair:
+  case Airplane_Pair:
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+uint64_t Move::counts() const {
+  uint64_t ans = 0;
+  for (int r = rank; r < rank + length; r++) {
+    ans += (uint64_t)multiplicity() << (4 * r);
+  }
+  int i = 0;
+  for (uint16_t k = kickers; k; k &= k - 1, i++) {
+    ans += (uint64_t)(kicker_multiplicity() + (pairs >> i & 1))
+           << (4 * std::countr_zero(k));
+  }
+  return ans;
+}
+
+int Move::size() const {
+  return multiplicity() * length +
+         kicker_multiplicity() * std::popcount(kickers) + std::popcount(pairs);
+}
+
+bool Move::beats(const Move &last) const {
+  if (is_none()) {
+    return false;
+  }
+  if (last.is_none()) {
+    return true;
+  }
+  if (last.type == UltraBomb) {
+    return false;
+  }
+  if (type == UltraBomb) {
+    return true;
+  }
+  if (type == Bomb && last.type != Bomb) {
+    return true;
+  }
+  return type == last.type && length == last.length && rank > last.rank;
+}
+
+CardSet Move::to_card_set(const Hand &hand) const {
+  if (is_none()) {
+    return CardSet(TYPE_START, {});
+  }
+  std::vector<Card> base;
+  for (int r = rank; r < rank + length; r++) {
+    auto cards = hand.take(r, multiplicity());
+    base.insert(base.end(), cards.begin(), cards.end());
+  }
+  if (kicker_multiplicity() == 0) {
+    return CardSet(get_type(), base);
+  }
+  std::vector<Card> extra;
+  int i = 0;
+  for (uint16_t k = kickers; k; k &= k - 1, i++) {
+    auto cards = hand.take(std::countr_zero(k),
+                           kicker_multiplicity() + (pairs >> i & 1));
+    extra.insert(extra.end(), cards.begin(), cards.end());
+  }
+  return CardSet(get_type(), base, extra);
+}
+
+Move Move::from_card_set(const CardSet &card_set) {
+  Type type = card_set.get_type();
+  if (type == TYPE_START) {
+    return none();
+  }
+  uint16_t base = 0;
+  for (const auto &c : card_set.get_base()) {
+    base |= 1 << c.get_rank();
+  }
+  uint16_t kickers = 0;
+  uint16_t twice = 0;
+  for (const auto &c : card_set.get_extra()) {
+    uint16_t bit = 1 << c.get_rank();
+    twice |= kickers & bit;
+    kickers |= bit;
+  }
+  uint8_t pairs = 0;
+  if (type.get_type_t() == Airplane_Single) {
+    // Bit i for the i-th lowest kicker
+    int i = 0;
+    for (uint16_t k = kickers; k; k &= k - 1, i++) {
+      if (twice & k & -k) {
+        pairs |= 1 << i;
+      }
+    }
+  }
+  return Move(type.get_type_t(), std::countr_zero(base), std::popcount(base),
+              kickers, pairs);
+}
+
+// Bits [0, 4) type, [4, 8) rank, [8, 12) length, [12, 27) kickers,
+// [27, 32) pairs
+uint32_t Move::encode() const {
+  return type | rank << 4 | length << 8 | (uint32_t)kickers << 12 |
+         (uint32_t)pairs << 27;
+}
+
+Move Move::decode(uint32_t code) {
+  return Move((type_t)(code & 0xF), code >> 4 & 0xF, code >> 8 & 0xF,
+              code >> 12 & 0x7FFF, code >> 27);
+}
+
+std::ostream &operator<<(std::ostream &os, const Move &m) {
+  // The suits are not printed, any hand with all the cards will do
+  static const Hand deck = Hand::from_cards((1ULL << 54) - 1);
+  return os << m.to_card_set(deck);
+}
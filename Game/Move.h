@@ -0,0 +1,86 @@
+#ifndef MOVE
+#define MOVE
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Card.h"
+
+class Hand;
+
+/**
+ * @brief A play, by ranks only, in 8 bytes.
+ *
+ * The base of the play uses `multiplicity()` cards of every rank in
+ * [rank, rank + length), and the kickers `kicker_multiplicity()` cards of
+ * every rank in `kickers`. The single wings of an airplane can use two cards
+ * of a rank: bit i of `pairs` is set if the i-th lowest rank of `kickers`
+ * gives two cards instead of one. Suits are only chosen when the move is
+ * turned into a CardSet (see to_card_set), so a Move is trivially copyable
+ * and can be stored by the million in search trees.
+ *
+ * A Move of type TYPE_START plays no card: it is the last play of a player
+ * who leads a round, and a pass.
+ */
+struct Move {
+  uint8_t type;   // type_t
+  uint8_t rank;   // Lowest rank of the base, see Card::get_rank
+  // Number of ranks of the base, 1 for non sequences and non airplanes
+  uint8_t length;
+  uint8_t pairs;    // Airplane_Single only, see above
+  uint16_t kickers; // Bit r is set if rank r is used as a kicker
+  uint16_t reserved;
+
+  Move() = default;
+  constexpr Move(type_t _type, int _rank = 0, int _length = 1,
+                 uint16_t _kickers = 0, uint8_t _pairs = 0)
+      : type((uint8_t)_type), rank((uint8_t)_rank), length((uint8_t)_length),
+        pairs(_pairs), kickers(_kickers), reserved(0) {}
+
+  static constexpr Move none() { return Move(TYPE_START, 0, 0); }
+  // 王炸 uses the two jokers, rank 13 and 14
+  static constexpr Move rocket() { return Move(UltraBomb, 13, 2); }
+
+  type_t get_type_t() const { return (type_t)type; }
+  bool is_none() const { return type == TYPE_START; }
+  Type get_type() const;
+
+  // Cards of every rank of the base
+  int multiplicity() const;
+  // Cards of every rank used as a kicker, one more for the ranks in pairs
+  int kicker_multiplicity() const;
+
+  // Number of cards of every rank, in the layout of Hand::get_counts()
+  uint64_t counts() const;
+  int size() const;
+
+  /**
+   * @brief Whether this move can be played after last
+   *
+   * @param last Move::none() if this move leads the round
+   */
+  bool beats(const Move &last) const;
+
+  /**
+   * @brief Choose the cards from the hand, lowest suit first
+   */
+  CardSet to_card_set(const Hand &hand) const;
+  static Move from_card_set(const CardSet &card_set);
+
+  // Compact form for storage, see decode
+  uint32_t encode() const;
+  static Move decode(uint32_t code);
+
+  friend bool operator==(const Move &m1, const Move &m2) {
+    return m1.type == m2.type && m1.rank == m2.rank &&
+           m1.length == m2.length && m1.kickers == m2.kickers &&
+           m1.pairs == m2.pairs;
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const Move &m);
+};
+
+static_assert(sizeof(Move) == 8);
+static_assert(std::is_trivially_copyable_v<Move>);
+
+#endif // MOVE
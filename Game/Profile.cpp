@@ -0,0 +1,202 @@
+#include "Profile.h"
+
+#ifdef ENABLE_PROFILE
+
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+// Bucket b counts the times with bit_width(cycles) == b
+constexpr int BUCKET_NUM = 65;
+
+struct Stats {
+  struct Section {
+    uint64_t calls = 0;
+    uint64_t cycles = 0;
+    uint64_t histogram[BUCKET_NUM] = {};
+  };
+  struct Type {
+    uint64_t calls = 0;
+    uint64_t cycles = 0;
+    uint64_t moves = 0;
+  };
+
+  Section sections[Profile::SECTION_END];
+  Type types[TYPE_END];
+  uint64_t allocations = 0;
+
+  Stats &operator+=(const Stats &s) {
+    for (int i = 0; i < Profile::SECTION_END; i++) {
+      sections[i].calls += s.sections[i].calls;
+      sections[i].cycles += s.sections[i].cycles;
+      for (int b = 0; b < BUCKET_NUM; b++) {
+        sections[i].histogram[b] += s.sections[i].histogram[b];
+      }
+    }
+    for (int i = 0; i < TYPE_END; i++) {
+      types[i].calls += s.types[i].calls;
+      types[i].cycles += s.types[i].cycles;
+      types[i].moves += s.types[i].moves;
+    }
+    allocations += s.allocations;
+    return *this;
+  }
+};
+
+const char *SECTION_NAMES[Profile::SECTION_END] = {
+    "get_moves", "get_possible_move", "trim_by_last_play", "remove",
+    "shuffle",   "deal",              "sort",
+};
+
+// Stats of the running threads, and the sum of the finished ones
+std::mutex registry_mutex;
+std::vector<const Stats *> running;
+Stats finished;
+
+// To convert cycles to nanoseconds
+const auto start_time = std::chrono::steady_clock::now();
+const uint64_t start_cycles = Profile::now();
+
+struct Local {
+  Stats stats;
+
+  Local() {
+    std::lock_guard lock(registry_mutex);
+    running.push_back(&stats);
+  }
+  ~Local() {
+    std::lock_guard lock(registry_mutex);
+    finished += stats;
+    std::erase(running, &stats);
+  }
+};
+
+Stats &local() {
+  thread_local Local l;
+  return l.stats;
+}
+
+class CountingResource : public std::pmr::memory_resource {
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    Profile::count_allocation();
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+CountingResource counting_resource;
+
+// Upper bound of the bucket holding the q quantile
+uint64_t quantile(const Stats::Section &s, double q) {
+  uint64_t seen = 0;
+  for (int b = 0; b < BUCKET_NUM; b++) {
+    seen += s.histogram[b];
+    if (seen >= q * s.calls) {
+      return b == 0 ? 0 : (b == 64 ? UINT64_MAX : (1ULL << b) - 1);
+    }
+  }
+  return UINT64_MAX;
+}
+
+} // namespace
+
+uint64_t Profile::now() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+void Profile::record(section_t section, uint64_t cycles) {
+  Stats::Section &s = local().sections[section];
+  s.calls++;
+  s.cycles += cycles;
+  s.histogram[std::bit_width(cycles)]++;
+}
+
+void Profile::record_type(type_t type, uint64_t cycles, uint64_t moves) {
+  Stats::Type &t = local().types[type];
+  t.calls++;
+  t.cycles += cycles;
+  t.moves += moves;
+}
+
+void Profile::count_allocation() { local().allocations++; }
+
+void Profile::count_allocation(std::pmr::memory_resource *resource) {
+  // The counting resource counts by itself
+  if (resource == std::pmr::new_delete_resource()) {
+    count_allocation();
+  }
+}
+
+std::pmr::memory_resource *Profile::heap() { return &counting_resource; }
+
+void Profile::dump(std::ostream &out) {
+  Stats total;
+  {
+    std::lock_guard lock(registry_mutex);
+    total = finished;
+    for (const Stats *s : running) {
+      total += *s;
+    }
+  }
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                    start_time)
+          .count();
+  double ns_per_cycle = seconds * 1e9 / (double)(now() - start_cycles);
+
+  char line[160];
+  std::snprintf(line, sizeof(line), "%-20s %12s %12s %10s %10s\n", "Section",
+                "calls", "total ms", "avg ns", "p99 ns");
+  out << line;
+  for (int i = 0; i < SECTION_END; i++) {
+    const Stats::Section &s = total.sections[i];
+    if (s.calls == 0) {
+      continue;
+    }
+    uint64_t p99 = quantile(s, 0.99);
+    std::snprintf(line, sizeof(line), "%-20s %12llu %12.2f %10.1f %10.0f\n",
+                  SECTION_NAMES[i], (unsigned long long)s.calls,
+                  s.cycles * ns_per_cycle / 1e6,
+                  s.cycles * ns_per_cycle / s.calls,
+                  p99 == UINT64_MAX ? -1.0 : p99 * ns_per_cycle);
+    out << line;
+  }
+
+  std::snprintf(line, sizeof(line), "\n%-20s %12s %12s %12s %10s\n", "Type",
+                "calls", "moves", "total ms", "ns/move");
+  out << line;
+  for (int i = TYPE_START + 1; i < TYPE_END; i++) {
+    const Stats::Type &t = total.types[i];
+    if (t.calls == 0) {
+      continue;
+    }
+    std::snprintf(line, sizeof(line), "%-20s %12llu %12llu %12.2f %10.1f\n",
+                  type_name((type_t)i), (unsigned long long)t.calls,
+                  (unsigned long long)t.moves, t.cycles * ns_per_cycle / 1e6,
+                  t.moves ? t.cycles * ns_per_cycle / t.moves : 0.0);
+    out << line;
+  }
+  out << "\nHeap allocations:    " << total.allocations << '\n';
+}
+
+#endif // ENABLE_PROFILE
@@ -0,0 +1,102 @@
+#ifndef PROFILE
+#define PROFILE
+
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+#include "Card.h"
+
+/**
+ * @brief Counters and cycle timers on the hot paths, to see where the time of
+ * a long simulation goes without a profiler.
+ *
+ * Only built with ENABLE_PROFILE defined (cmake -DENABLE_PROFILE=ON).
+ * Otherwise every class here is empty and every function inline and empty,
+ * so the calls in the hot paths compile to nothing.
+ *
+ * Every thread counts in its own thread_local stats, with no lock and no
+ * atomic. The stats of a thread are added to a shared total when it exits.
+ * dump() sums the total and the running threads. It must be called when the
+ * other threads are idle, usually at the end of a run.
+ */
+namespace Profile {
+
+// The timed sections
+enum section_t {
+  GET_MOVES,         // Strategy::get_moves
+  GET_POSSIBLE_MOVE, // Strategy::get_possible_move
+  TRIM_BY_LAST_PLAY, // Strategy::trim_by_last_play
+  REMOVE,            // Hand::remove(Move)
+  SHUFFLE,           // Deck::shuffle
+  DEAL,              // Deck::deal
+  SORT,              // Hand::to_vector, the cards sorted by rank
+  SECTION_END,
+};
+
+#ifdef ENABLE_PROFILE
+
+// Time stamp counter, or nanoseconds where there is none
+uint64_t now();
+
+void record(section_t section, uint64_t cycles);
+void record_type(type_t type, uint64_t cycles, uint64_t moves);
+// An allocation on the global heap
+void count_allocation();
+// An allocation in resource, counted if it comes from the global heap
+void count_allocation(std::pmr::memory_resource *resource);
+// The global heap, counting its allocations: the upstream of every Arena
+std::pmr::memory_resource *heap();
+
+// Times its own lifetime
+class Scope {
+private:
+  section_t section;
+  uint64_t start;
+
+public:
+  explicit Scope(section_t _section) : section(_section), start(now()) {}
+  Scope(const Scope &) = delete;
+  ~Scope() { record(section, now() - start); }
+};
+
+// Times the generation of the moves of one type in Strategy
+class TypeTimer {
+private:
+  type_t type;
+  uint64_t start;
+
+public:
+  explicit TypeTimer(type_t _type) : type(_type), start(now()) {}
+  void stop(uint64_t moves) { record_type(type, now() - start, moves); }
+};
+
+// Calls, total, average and p99 time of every section, moves and time of
+// every type and allocations, summed over all threads
+void dump(std::ostream &out);
+
+#else
+
+class Scope {
+public:
+  explicit Scope(section_t) {}
+};
+
+class TypeTimer {
+public:
+  explicit TypeTimer(type_t) {}
+  void stop(uint64_t) {}
+};
+
+inline void count_allocation() {}
+inline void count_allocation(std::pmr::memory_resource *) {}
+inline std::pmr::memory_resource *heap() {
+  return std::pmr::get_default_resource();
+}
+inline void dump(std::ostream &) {}
+
+#endif // ENABLE_PROFILE
+
+} // namespace Profile
+
+#endif // PROFILE
@@ -0,0 +1,253 @@
+#include "Protocol.h"
+
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+void put(std::vector<char> &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out.push_back((char)(value >> (8 * i)));
+  }
+}
+
+// Reads integers from a payload, and remembers if it ran past the end
+struct Reader {
+  const unsigned char *p;
+  size_t left;
+  bool ok = true;
+
+  uint64_t get(int bytes) {
+    if ((size_t)bytes > left) {
+      ok = false;
+      return 0;
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+      value |= (uint64_t)p[i] << (8 * i);
+    }
+    p += bytes;
+    left -= bytes;
+    return value;
+  }
+};
+
+// Closes the socket of a failed listen_on or connect_to before throwing, so
+// that a caller catching the error does not leak it
+[[noreturn]] void fail(int fd, const std::string &message) {
+  if (fd >= 0) {
+    close(fd);
+  }
+  throw std::runtime_error(message);
+}
+
+bool is_unix(const std::string &address) {
+  return address.compare(0, 5, "unix:") == 0;
+}
+
+sockaddr_un unix_address(const std::string &address) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::string path = address.substr(5);
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw std::runtime_error("Socket path too long: " + path);
+  }
+  std::strcpy(addr.sun_path, path.c_str());
+  return addr;
+}
+
+addrinfo *tcp_address(const std::string &address, bool passive) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    throw std::runtime_error("Expected host:port, got " + address);
+  }
+  std::string host = address.substr(0, colon);
+  std::string port = address.substr(colon + 1);
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = passive ? AI_PASSIVE : 0;
+  addrinfo *result;
+  if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints,
+                  &result) != 0) {
+    throw std::runtime_error("Can not resolve " + address);
+  }
+  return result;
+}
+
+} // namespace
+
+void Protocol::encode(const Message &message, std::vector<char> &out) {
+  size_t start = out.size();
+  // The size is written once the payload is known
+  put(out, 0, 4);
+  put(out, message.type, 1);
+  put(out, message.table, 4);
+  switch (message.type) {
+  case MSG_OPEN:
+    put(out, message.seed, 8);
+    put(out, message.rule, 1);
+    break;
+  case MSG_BID:
+    put(out, message.answer, 1);
+    break;
+  case MSG_MOVE:
+    put(out, message.move.encode(), 4);
+    break;
+  case MSG_BID_REQUEST:
+    put(out, message.player, 1);
+    put(out, message.stage, 1);
+    put(out, message.highest, 1);
+    put(out, message.hand, 8);
+    break;
+  case MSG_MOVE_REQUEST:
+    put(out, message.player, 1);
+    put(out, message.landlord, 1);
+    put(out, message.last_player & 0xFF, 1);
+    put(out, message.move.encode(), 4);
+    put(out, message.hand, 8);
+    for (int i = 0; i < 3; i++) {
+      put(out, message.hand_size[i], 1);
+    }
+    break;
+  case MSG_GAME_OVER:
+    put(out, message.winner, 1);
+    put(out, message.landlord, 1);
+    break;
+  case MSG_ERROR:
+    break;
+  }
+  uint32_t size = out.size() - start - 4;
+  for (int i = 0; i < 4; i++) {
+    out[start + i] = (char)(size >> (8 * i));
+  }
+}
+
+bool Protocol::decode(const char *payload, size_t size, Message &message) {
+  Reader r{(const unsigned char *)payload, size};
+  message.type = (message_t)r.get(1);
+  message.table = r.get(4);
+  switch (message.type) {
+  case MSG_OPEN:
+    message.seed = r.get(8);
+    message.rule = (bid_rule_t)r.get(1);
+    // Comes from the network, Auction only knows these
+    if (message.rule != RULE_ROB && message.rule != RULE_POINTS) {
+      return false;
+    }
+    break;
+  case MSG_BID:
+    message.answer = r.get(1);
+    break;
+  case MSG_MOVE:
+    message.move = Move::decode(r.get(4));
+    break;
+  case MSG_BID_REQUEST:
+    message.player = r.get(1);
+    message.stage = (bid_stage_t)r.get(1);
+    if (message.stage > BID_POINTS) {
+      return false;
+    }
+    message.highest = r.get(1);
+    message.hand = r.get(8);
+    break;
+  case MSG_MOVE_REQUEST:
+    message.player = r.get(1);
+    message.landlord = r.get(1);
+    message.last_player = (int8_t)r.get(1);
+    message.move = Move::decode(r.get(4));
+    message.hand = r.get(8);
+    for (int i = 0; i < 3; i++) {
+      message.hand_size[i] = r.get(1);
+    }
+    break;
+  case MSG_GAME_OVER:
+    message.winner = r.get(1);
+    message.landlord = r.get(1);
+    break;
+  case MSG_ERROR:
+    break;
+  default:
+    // Unknown type
+    return false;
+  }
+  return r.ok && r.left == 0;
+}
+
+long Protocol::frame_size(const char *data, size_t size) {
+  if (size < 4) {
+    return 0;
+  }
+  uint32_t payload = 0;
+  for (int i = 0; i < 4; i++) {
+    payload |= (uint32_t)(unsigned char)data[i] << (8 * i);
+  }
+  if (payload > MAX_PAYLOAD) {
+    return -1;
+  }
+  return size >= 4 + payload ? 4 + payload : 0;
+}
+
+int Protocol::listen_on(const std::string &address) {
+  int fd;
+  if (is_unix(address)) {
+    sockaddr_un addr = unix_address(address);
+    // A socket file left by a previous server would make bind fail
+    unlink(addr.sun_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+      fail(fd, "Can not bind " + address);
+    }
+  } else {
+    addrinfo *info = tcp_address(address, true);
+    fd = socket(info->ai_family, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    bool bound = fd >= 0 && bind(fd, info->ai_addr, info->ai_addrlen) == 0;
+    freeaddrinfo(info);
+    if (!bound) {
+      fail(fd, "Can not bind " + address);
+    }
+  }
+  if (listen(fd, SOMAXCONN) < 0) {
+    fail(fd, "Can not listen on " + address);
+  }
+  return fd;
+}
+
+int Protocol::connect_to(const std::string &address) {
+  int fd;
+  if (is_unix(address)) {
+    sockaddr_un addr = unix_address(address);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+      fail(fd, "Can not connect to " + address);
+    }
+  } else {
+    addrinfo *info = tcp_address(address, false);
+    // ":port" resolves to ::1 and 127.0.0.1, the server may only listen on
+    // one of them
+    fd = -1;
+    for (addrinfo *a = info; a && fd < 0; a = a->ai_next) {
+      fd = socket(a->ai_family, SOCK_STREAM, 0);
+      if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) < 0) {
+        close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(info);
+    if (fd < 0) {
+      throw std::runtime_error("Can not connect to " + address);
+    }
+    // Messages are tiny and latency matters more than packet count
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  return fd;
+}
@@ -0,0 +1,101 @@
+#ifndef PROTOCOL
+#define PROTOCOL
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Agent.h"
+#include "Move.h"
+
+/**
+ * @brief Messages between the game server and the programs playing on it.
+ *
+ * A connection plays all three seats of the tables it opens, and can have
+ * any number of tables open at once. Every message is a frame: the payload
+ * size on 4 bytes, then the payload, starting with the message type and the
+ * table id chosen by the client in MSG_OPEN. Integers are little-endian.
+ *
+ *   client -> server
+ *     MSG_OPEN          table, seed (8), rule (1) open a table and deal
+ *     MSG_BID           table, answer (1)         1 for yes, 0 for no, or
+ *                                                 the points for BID_POINTS
+ *     MSG_MOVE          table, move (4)           Move::encode(), none to pass
+ *   server -> client
+ *     MSG_BID_REQUEST   table, player (1), stage (1), highest bid (1),
+ *                       hand (8)
+ *     MSG_MOVE_REQUEST  table, player (1), landlord (1), last player (1),
+ *                       last play (4), hand (8), hand sizes (3)
+ *     MSG_GAME_OVER     table, winner (1), landlord (1)
+ *     MSG_ERROR         table                     bad answer or message,
+ *                                                 table closed
+ *
+ * Hands are card masks (Hand::get_cards()), the last player is 0xFF when
+ * the player leads. Players who can not beat the last play pass without
+ * being asked.
+ */
+namespace Protocol {
+
+enum message_t : uint8_t {
+  MSG_OPEN = 1,
+  MSG_BID,
+  MSG_MOVE,
+  MSG_BID_REQUEST,
+  MSG_MOVE_REQUEST,
+  MSG_GAME_OVER,
+  MSG_ERROR,
+};
+
+// Larger frames are rejected, every message is much smaller
+constexpr size_t MAX_PAYLOAD = 64;
+
+/**
+ * @brief Any message, only the fields of its type are used
+ */
+struct Message {
+  message_t type;
+  uint32_t table;
+  uint64_t seed = 0;
+  bid_rule_t rule = RULE_ROB;
+  int player = 0;
+  int landlord = 0;
+  int last_player = -1;
+  bid_stage_t stage = BID_CALL;
+  int highest = 0;
+  int answer = 0;
+  // MSG_MOVE: the move, MSG_MOVE_REQUEST: the last play
+  Move move = Move::none();
+  uint64_t hand = 0;
+  int hand_size[3] = {0, 0, 0};
+  int winner = 0;
+};
+
+// Append the frame of the message to out
+void encode(const Message &message, std::vector<char> &out);
+
+/**
+ * @param payload A frame without its size
+ * @return false if it is not a valid message: an unknown type or bid rule,
+ * or a size that does not match the type
+ */
+bool decode(const char *payload, size_t size, Message &message);
+
+/**
+ * @brief Look for a whole frame at the start of data
+ *
+ * @return The size of the frame (size prefix included), 0 if more bytes are
+ * needed, or -1 if the frame is too large
+ */
+long frame_size(const char *data, size_t size);
+
+/**
+ * @brief Sockets, "unix:/path" for a Unix-domain socket, "host:port" or
+ * ":port" (all addresses) for TCP. Both throw std::runtime_error on failure.
+ */
+int listen_on(const std::string &address);
+int connect_to(const std::string &address);
+
+} // namespace Protocol
+
+#endif // PROTOCOL
@@ -0,0 +1,14 @@
+#include "Random.h"
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+Random &thread_random() {
+  thread_local Random rng{
+      std::random_device{}() ^
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+      (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count()};
+  return rng;
+}
@@ -0,0 +1,79 @@
+#ifndef RANDOM
+#define RANDOM
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief xoshiro256** pseudo random generator.
+ *
+ * Cheap to copy and to seed, so every thread (or every game) can own one.
+ * Satisfies UniformRandomBitGenerator, so it also works with <random> and
+ * std::shuffle.
+ */
+class Random {
+private:
+  uint64_t s[4];
+
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+  using result_type = uint64_t;
+
+  explicit Random(uint64_t seed) {
+    // The state must not be all zero, splitmix64 never gives 4 zeros in a row
+    for (auto &x : s) {
+      seed += 0x9E3779B97F4A7C15ULL;
+      x = mix(seed);
+    }
+  }
+
+  /**
+   * @brief splitmix64 finalizer, turns close integers (like game indices)
+   * into unrelated seeds
+   */
+  static uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  uint64_t operator()() {
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief Uniform integer in [0, n), without modulo bias (Lemire's method)
+   */
+  uint32_t bounded(uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)(*this)() * n;
+    if ((uint32_t)m < n) {
+      uint32_t threshold = -n % n;
+      while ((uint32_t)m < threshold) {
+        m = (uint64_t)(uint32_t)(*this)() * n;
+      }
+    }
+    return m >> 32;
+  }
+};
+
+/**
+ * @brief Generator of the calling thread, seeded differently for every thread
+ * and every run. Use it only where reproducibility does not matter.
+ */
+Random &thread_random();
+
+#endif // RANDOM
@@ -0,0 +1,133 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "Strategy.h"
+#include "Table.h"
+
+namespace {
+
+const char *STATUS_NAMES[Replay::STATUS_END] = {
+    "ok", "bad bid", "bad deal", "bad move", "bad outcome", "mismatch",
+};
+
+// A hand with every card, to turn any move into a CardSet
+const Hand ALL_CARDS = Hand::from_cards((1ULL << 54) - 1);
+
+// The moves of the position by the CardSet functions are the moves of the
+// generator
+bool audit(const GameState &state) {
+  const Hand &hand = state.hands[state.turn];
+  std::vector<CardSet> sets;
+  if (state.last_play.is_none()) {
+    sets = Strategy::get_possible_move(hand, Type(TYPE_START));
+  } else {
+    std::vector<CardSet> all =
+        Strategy::get_possible_move(hand, state.last_play.get_type());
+    sets = Strategy::trim_by_last_play(all,
+                                       state.last_play.to_card_set(ALL_CARDS));
+  }
+  std::vector<uint32_t> slow;
+  for (const auto &c : sets) {
+    slow.push_back(Move::from_card_set(c).encode());
+  }
+  std::vector<uint32_t> fast;
+  for (const auto &m : Strategy::get_moves(hand, state.last_play)) {
+    fast.push_back(m.encode());
+  }
+  std::sort(slow.begin(), slow.end());
+  std::sort(fast.begin(), fast.end());
+  return slow == fast;
+}
+
+} // namespace
+
+const char *Replay::to_string(status_t status) {
+  assert(status >= OK && status < STATUS_END);
+  return STATUS_NAMES[status];
+}
+
+Replay::Result Replay::verify(const GameRecord &record, bool audit_moves,
+                              std::ostream *log) {
+  if (record.rule != RULE_ROB && record.rule != RULE_POINTS) {
+    return {BAD_BID, -1};
+  }
+  Table table(record.seed, (bid_rule_t)record.rule);
+  for (size_t i = 0; i < record.bids.size(); i++) {
+    int player = table.get_player();
+    if (!table.is_bidding() || !table.bid(record.bids[i])) {
+      return {BAD_BID, (int)i};
+    }
+    if (log) {
+      *log << "Player " << player << " bids " << (int)record.bids[i] << '\n';
+    }
+  }
+  if (table.is_bidding()) {
+    return {BAD_BID, (int)record.bids.size()};
+  }
+
+  // Kept up to date by the table
+  const GameState &state = table.get_state();
+  int landlord = state.landlord;
+  if (landlord != record.landlord ||
+      table.get_first_bidder() != record.first_bidder ||
+      table.get_redeals() != record.redeals ||
+      table.get_landlord_cards().get_cards() != record.landlord_cards) {
+    return {BAD_DEAL, -1};
+  }
+  for (int p = 0; p < 3; p++) {
+    uint64_t cards = record.hands[p];
+    if (p == landlord) {
+      cards |= record.landlord_cards;
+    }
+    if (state.hands[p].get_cards() != cards) {
+      return {BAD_DEAL, -1};
+    }
+  }
+  if (log) {
+    *log << "Player " << landlord << " is the landlord\n";
+  }
+
+  for (size_t i = 0; i < record.moves.size(); i++) {
+    const Move &move = record.moves[i];
+    // Every turn has a move in the record, passes included
+    int player = (landlord + i) % 3;
+    if (table.is_over()) {
+      return {BAD_OUTCOME, (int)i};
+    }
+    if (state.turn != player) {
+      // The table already passed for this player, who could not play
+      if (!move.is_none()) {
+        return {BAD_MOVE, (int)i};
+      }
+      if (log) {
+        *log << "Player " << player << " can not play\n";
+      }
+      continue;
+    }
+    if (audit_moves && !audit(state)) {
+      return {MISMATCH, (int)i};
+    }
+    if (!table.play(move)) {
+      return {BAD_MOVE, (int)i};
+    }
+    if (log) {
+      *log << "Player " << player << ": ";
+      if (move.is_none()) {
+        *log << "pass";
+      } else {
+        *log << move;
+      }
+      *log << '\n';
+    }
+  }
+  if (!table.is_over() || state.winner() != record.winner) {
+    return {BAD_OUTCOME, (int)record.moves.size()};
+  }
+  if (log) {
+    *log << "Player " << record.winner << " wins\n";
+  }
+  return {OK, -1};
+}
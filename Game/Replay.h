@@ -0,0 +1,56 @@
+#ifndef REPLAY
+#define REPLAY
+
+#include <ostream>
+
+#include "GameRecord.h"
+
+/**
+ * @brief Play a recorded game again from its seed and its answers, and check
+ * that the engine agrees with the record.
+ *
+ * The game is run by a Table seeded with the seed of the record: it deals,
+ * takes the recorded bids one by one, and takes the recorded moves, checking
+ * every one of them with the generator. The deal, the bidding and the winner
+ * must then be the ones recorded. A Table passes at once for the players who
+ * can not beat the last play; the record has a Move::none() for them, which
+ * must fall on those turns.
+ *
+ * A record written by an engine with other rules (the move generation, the
+ * auction, the deck) fails at the first answer where they differ, which
+ * tells where two versions of the engine part.
+ */
+namespace Replay {
+
+enum status_t {
+  OK,
+  BAD_BID,     // Refused by the auction, or the bids end before it does
+  BAD_DEAL,    // Another deal, first bidder, redeal count or landlord
+  BAD_MOVE,    // Not legal, or not a forced pass where one is due
+  BAD_OUTCOME, // The game ends at another move or with another winner
+  // Audit only: the CardSet functions of Strategy and the generator give
+  // different moves
+  MISMATCH,
+  STATUS_END,
+};
+
+const char *to_string(status_t status);
+
+struct Result {
+  status_t status;
+  // The bid (BAD_BID) or move where the replay failed, -1 if none
+  int index;
+};
+
+/**
+ * @param audit Also check every position with Strategy::get_possible_move
+ * and trim_by_last_play, and that they give the same moves as the
+ * generator. Much slower.
+ * @param log Where to print the bids and moves, nullptr to print nothing
+ */
+Result verify(const GameRecord &record, bool audit = false,
+              std::ostream *log = nullptr);
+
+} // namespace Replay
+
+#endif // REPLAY
@@ -0,0 +1,125 @@
+#ifndef SEQUENCE
+#define SEQUENCE
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Compile-time tables of the sequences (顺子, 双顺, 三顺).
+ *
+ * A sequence uses `multiplicity` cards of every rank in
+ * [start, start + length). Only ranks 3 to A (rank index 0 to 11) can be in a
+ * sequence.
+ */
+namespace Sequence {
+
+constexpr int MAX_RANK = 12;
+// Indexed by multiplicity, 0 is unused
+constexpr int MIN_LENGTH[4] = {0, 5, 3, 2};
+constexpr int MAX_LENGTH = MAX_RANK;
+
+// Ranks 3 to A, bit r for rank r
+constexpr uint16_t RANKS = (1 << MAX_RANK) - 1;
+
+struct Window {
+  uint8_t start;
+  uint8_t length;
+  uint8_t multiplicity;
+  // Bit r is set for every rank of the window
+  uint16_t mask;
+};
+
+constexpr int window_count_of_length(int length) {
+  return MAX_RANK - length + 1;
+}
+
+constexpr int window_count(int multiplicity) {
+  int n = 0;
+  for (int l = MIN_LENGTH[multiplicity]; l <= MAX_LENGTH; l++) {
+    n += window_count_of_length(l);
+  }
+  return n;
+}
+
+constexpr int WINDOW_NUM = window_count(1) + window_count(2) + window_count(3);
+
+// Every legal window, ordered by multiplicity, then length, then start
+constexpr std::array<Window, WINDOW_NUM> WINDOWS = []() {
+  std::array<Window, WINDOW_NUM> table{};
+  int i = 0;
+  for (int m = 1; m <= 3; m++) {
+    for (int l = MIN_LENGTH[m]; l <= MAX_LENGTH; l++) {
+      for (int s = 0; s + l <= MAX_RANK; s++) {
+        table[i++] = {(uint8_t)s, (uint8_t)l, (uint8_t)m,
+                      (uint16_t)(((1 << l) - 1) << s)};
+      }
+    }
+  }
+  return table;
+}();
+
+// OFFSET[m][l] is the index in WINDOWS of the first window of multiplicity m
+// and length l. Windows of length l are [OFFSET[m][l], OFFSET[m][l + 1])
+constexpr std::array<std::array<int, MAX_LENGTH + 2>, 4> OFFSET = []() {
+  std::array<std::array<int, MAX_LENGTH + 2>, 4> table{};
+  int i = 0;
+  for (int m = 1; m <= 3; m++) {
+    for (int l = 0; l <= MAX_LENGTH + 1; l++) {
+      table[m][l] = i;
+      if (l >= MIN_LENGTH[m] && l <= MAX_LENGTH) {
+        i += window_count_of_length(l);
+      }
+    }
+  }
+  return table;
+}();
+
+// The windows of multiplicity and length whose start is at least min_start,
+// in increasing start
+constexpr std::span<const Window> windows(int multiplicity, int length,
+                                          int min_start = 0) {
+  int begin = OFFSET[multiplicity][length];
+  int end = OFFSET[multiplicity][length + 1];
+  begin = std::min(begin + min_start, end);
+  return {WINDOWS.data() + begin, WINDOWS.data() + end};
+}
+
+// Bit s is set if ranks [s, s + length) are all in ranks, so that a
+// sequence of this length can start at s
+constexpr uint16_t window_starts(uint16_t ranks, int length) {
+  ranks &= RANKS;
+  uint16_t starts = ranks;
+  for (int j = 1; j < length; j++) {
+    starts &= ranks >> j;
+  }
+  return starts;
+}
+
+/**
+ * @brief Call f(start, length) for every sequence inside the given ranks, of
+ * every length up to max_length, in one pass over the start ranks
+ *
+ * @param ranks Ranks that have at least multiplicity cards
+ */
+template <typename Func>
+void for_each(uint16_t ranks, int multiplicity, Func &&f,
+              int max_length = MAX_LENGTH) {
+  ranks &= RANKS;
+  int min_length = MIN_LENGTH[multiplicity];
+  for (uint16_t m = ranks; m; m &= m - 1) {
+    int start = std::countr_zero(m);
+    // Length of the run of ranks beginning at start
+    int run = std::min(std::countr_one((unsigned)(ranks >> start)),
+                       max_length);
+    for (int l = min_length; l <= run; l++) {
+      f(start, l);
+    }
+  }
+}
+
+} // namespace Sequence
+
+#endif // SEQUENCE
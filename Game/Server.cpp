@@ -0,0 +1,282 @@
+#include "Server.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using Protocol::Message;
+
+Server::Server(const std::string &address, int _thread_num)
+    : listen_fd(Protocol::listen_on(address)),
+      stop_fd(eventfd(0, EFD_NONBLOCK)), thread_num(_thread_num),
+      stopping(false), games(0) {
+  assert(thread_num >= 1);
+  // Every thread accepts on it, none of them may block
+  if (stop_fd < 0 ||
+      fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK) < 0) {
+    throw std::runtime_error("Can not set up the server sockets");
+  }
+}
+
+Server::~Server() {
+  close(listen_fd);
+  close(stop_fd);
+}
+
+void Server::run() {
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_num; i++) {
+    threads.emplace_back(&Server::loop, this);
+  }
+  loop();
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void Server::stop() {
+  stopping = true;
+  // Level-triggered and never read, so it wakes up every thread
+  uint64_t one = 1;
+  [[maybe_unused]] ssize_t n = write(stop_fd, &one, sizeof(one));
+}
+
+void Server::loop() {
+  int epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    throw std::runtime_error("Can not create an epoll instance");
+  }
+  // The two fixed sockets are told apart from connections by their address
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+  ev.data.ptr = &listen_fd;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+  ev.events = EPOLLIN;
+  ev.data.ptr = &stop_fd;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &ev);
+
+  std::unordered_map<int, std::unique_ptr<Connection>> connections;
+  const int MAX_EVENTS = 256;
+  epoll_event events[MAX_EVENTS];
+  while (!stopping) {
+    int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+    if (n < 0 && errno != EINTR) {
+      break;
+    }
+    for (int i = 0; i < n; i++) {
+      void *ptr = events[i].data.ptr;
+      if (ptr == &stop_fd) {
+        continue;
+      }
+      if (ptr == &listen_fd) {
+        accept_all(epoll_fd, connections);
+        continue;
+      }
+      Connection &c = *(Connection *)ptr;
+      bool ok = !(events[i].events & (EPOLLHUP | EPOLLERR));
+      if (ok && (events[i].events & EPOLLIN)) {
+        ok = read_all(c);
+      }
+      if (ok) {
+        ok = write_all(epoll_fd, c);
+      }
+      if (!ok) {
+        // erase destroys c, the key must not be read from it
+        int fd = c.fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections.erase(fd);
+      }
+    }
+  }
+
+  for (auto &[fd, c] : connections) {
+    close(fd);
+  }
+  close(epoll_fd);
+}
+
+void Server::accept_all(
+    int epoll_fd, std::unordered_map<int, std::unique_ptr<Connection>> &all) {
+  while (true) {
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      // EAGAIN: another thread took it, or no connection left
+      return;
+    }
+    // Fails harmlessly on Unix-domain sockets
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    auto c = std::make_unique<Connection>();
+    c->fd = fd;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = c.get();
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    all[fd] = std::move(c);
+  }
+}
+
+bool Server::read_all(Connection &c) {
+  char chunk[64 * 1024];
+  while (true) {
+    ssize_t n = recv(c.fd, chunk, sizeof(chunk), 0);
+    if (n == 0) {
+      // Closed by the client
+      return false;
+    }
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    c.in.insert(c.in.end(), chunk, chunk + n);
+    // Handled chunk by chunk, so that in holds at most one chunk and the
+    // limit of out stops a client that sends faster than it reads
+    if (!handle_frames(c)) {
+      return false;
+    }
+    if ((size_t)n < sizeof(chunk)) {
+      break;
+    }
+  }
+  return true;
+}
+
+bool Server::handle_frames(Connection &c) {
+  size_t used = 0;
+  while (true) {
+    long size = Protocol::frame_size(c.in.data() + used, c.in.size() - used);
+    if (size < 0) {
+      return false;
+    }
+    if (size == 0) {
+      break;
+    }
+    Message message;
+    if (!Protocol::decode(c.in.data() + used + 4, size - 4, message)) {
+      // An unknown type or rule, the table id is still read when there is one
+      reject(c, message.table);
+    } else if (!handle(c, message)) {
+      return false;
+    }
+    if (c.out.size() - c.sent > MAX_OUTPUT) {
+      return false;
+    }
+    used += size;
+  }
+  c.in.erase(c.in.begin(), c.in.begin() + used);
+  return true;
+}
+
+bool Server::handle(Connection &c, const Message &message) {
+  uint32_t id = message.table;
+  if (message.type == Protocol::MSG_OPEN) {
+    auto &table = c.tables[id];
+    table = std::make_unique<Table>(message.seed, message.rule);
+    request(c, id, *table);
+    return true;
+  }
+  if (message.type != Protocol::MSG_BID && message.type != Protocol::MSG_MOVE) {
+    // Only the server sends the other messages
+    return false;
+  }
+
+  auto it = c.tables.find(id);
+  bool ok = it != c.tables.end();
+  if (ok) {
+    Table &table = *it->second;
+    ok = message.type == Protocol::MSG_BID ? table.bid(message.answer)
+                                           : table.play(message.move);
+  }
+  if (!ok) {
+    reject(c, id);
+    return true;
+  }
+  request(c, id, *it->second);
+  if (it->second->is_over()) {
+    c.tables.erase(it);
+    games.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void Server::reject(Connection &c, uint32_t id) {
+  Message error{Protocol::MSG_ERROR, id};
+  Protocol::encode(error, c.out);
+  c.tables.erase(id);
+}
+
+void Server::request(Connection &c, uint32_t id, const Table &table) {
+  Message m{Protocol::MSG_ERROR, id};
+  if (table.is_over()) {
+    m.type = Protocol::MSG_GAME_OVER;
+    m.winner = table.get_state().winner();
+    m.landlord = table.get_state().landlord;
+  } else if (table.is_bidding()) {
+    m.type = Protocol::MSG_BID_REQUEST;
+    m.player = table.get_player();
+    m.stage = table.get_stage();
+    m.highest = table.get_highest();
+    m.hand = table.get_hand(m.player).get_cards();
+  } else {
+    const GameState &state = table.get_state();
+    m.type = Protocol::MSG_MOVE_REQUEST;
+    m.player = state.turn;
+    m.landlord = state.landlord;
+    m.last_player = state.last_player;
+    m.move = state.last_play;
+    m.hand = state.hands[state.turn].get_cards();
+    for (int i = 0; i < 3; i++) {
+      m.hand_size[i] = state.hands[i].size();
+    }
+  }
+  Protocol::encode(m, c.out);
+}
+
+bool Server::write_all(int epoll_fd, Connection &c) {
+  while (c.sent < c.out.size()) {
+    ssize_t n = send(c.fd, c.out.data() + c.sent, c.out.size() - c.sent,
+                     MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        return false;
+      }
+      // The socket is full, go on when it can take more
+      if (!c.writing) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT;
+        ev.data.ptr = &c;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+        c.writing = true;
+      }
+      return true;
+    }
+    c.sent += n;
+  }
+  c.out.clear();
+  c.sent = 0;
+  if (c.writing) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &c;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+    c.writing = false;
+  }
+  return true;
+}
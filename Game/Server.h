@@ -0,0 +1,78 @@
+#ifndef SERVER
+#define SERVER
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Protocol.h"
+#include "Table.h"
+
+/**
+ * @brief Game server hosting the tables of many connections, see Protocol.h.
+ *
+ * A fixed number of threads each run an epoll loop. All of them wait on the
+ * listening socket (EPOLLEXCLUSIVE, so one of them wakes up per connection)
+ * and a connection stays with the thread that accepted it, with its tables.
+ * A thread never blocks on a socket and no state is shared between threads,
+ * so there is no lock and no thread per connection.
+ */
+class Server {
+private:
+  struct Connection {
+    int fd;
+    std::vector<char> in;
+    std::vector<char> out;
+    // Bytes of out already sent
+    size_t sent = 0;
+    // Waiting for EPOLLOUT because the socket was full
+    bool writing = false;
+    std::unordered_map<uint32_t, std::unique_ptr<Table>> tables;
+  };
+
+  // Unsent bytes a connection can have, a client that sends requests without
+  // reading the answers is dropped when it has more
+  static constexpr size_t MAX_OUTPUT = 1 << 20;
+
+  int listen_fd;
+  // Written to wake up the threads when stopping
+  int stop_fd;
+  int thread_num;
+  std::atomic<bool> stopping;
+  std::atomic<uint64_t> games;
+
+  void loop();
+  void accept_all(int epoll_fd,
+                  std::unordered_map<int, std::unique_ptr<Connection>> &all);
+  // false if the connection has to be closed
+  bool read_all(Connection &c);
+  // Handle the whole frames of c.in, false if the connection has to be closed
+  bool handle_frames(Connection &c);
+  bool handle(Connection &c, const Protocol::Message &message);
+  // Answer MSG_ERROR and close the table
+  void reject(Connection &c, uint32_t id);
+  bool write_all(int epoll_fd, Connection &c);
+
+  // Tell the player of the table what it has to answer, or the end
+  void request(Connection &c, uint32_t id, const Table &table);
+
+public:
+  /**
+   * @param address See Protocol::listen_on
+   * @param _thread_num Number of event loops
+   */
+  Server(const std::string &address, int _thread_num);
+  ~Server();
+
+  // Serve until stop() is called, from another thread or a signal handler
+  void run();
+  void stop();
+
+  // Number of games finished so far
+  uint64_t get_games() const { return games; }
+};
+
+#endif // SERVER
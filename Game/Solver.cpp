@@ -0,0 +1,304 @@
+#include "Solver.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Sequence.h"
+#include "Strategy.h"
+#include "Zobrist.h"
+
+namespace {
+
+// History counts are capped below this, so that they only order the moves
+// of equal plays and size in the keys of search
+constexpr int HISTORY_MAX = 1 << 20;
+
+// The rest of a hand is only split into unbeatable plays (plays_out) when
+// it needs at most this many plays: beyond, the splits cost more than they
+// find
+constexpr int SPLIT_MAX = 2;
+
+// A move, with what is known of it before it is searched
+struct Candidate {
+  Move move;
+  // At least how many plays the rest of the hand needs
+  int plays;
+  // The variant tried before the other kicker variants of its move
+  bool first;
+  // Larger is tried first
+  uint64_t key;
+};
+
+// Kicker variants of a move (ThreeOne, airplanes, ...) share the class, and
+// Strategy generates them one after the other, the lowest kickers first
+uint32_t move_class(const Move &m) {
+  return (uint32_t)m.type << 16 | m.rank << 8 | m.length;
+}
+
+/**
+ * @brief When no hand can hold a sequence or an airplane (and none can later,
+ * as hands only shrink), moves only compare ranks. The result then only
+ * depends on the order of the ranks held, so these positions are keyed by
+ * the index of every rank among the ranks held: positions that only differ
+ * by ranks nobody holds any more share their entry. The jokers keep their
+ * ranks, for the rocket.
+ */
+class RankOrder {
+private:
+  bool relative;
+  // Rank to index, and back
+  int8_t index[Hand::RANK_NUM];
+  int8_t rank[Hand::RANK_NUM];
+  uint16_t held;
+
+  Move map(const Move &m, const int8_t (&to)[Hand::RANK_NUM]) const {
+    if (!relative || m.is_none()) {
+      return m;
+    }
+    Move ans = m;
+    ans.rank = to[m.rank];
+    ans.kickers = 0;
+    for (uint16_t k = m.kickers; k; k &= k - 1) {
+      ans.kickers |= 1 << to[std::countr_zero(k)];
+    }
+    return ans;
+  }
+
+public:
+  explicit RankOrder(const GameState &state) : relative(true), held(0) {
+    for (const auto &hand : state.hands) {
+      for (int m = 1; m <= 3; m++) {
+        if (Sequence::window_starts(hand.ranks_with_at_least(m),
+                                    Sequence::MIN_LENGTH[m])) {
+          relative = false;
+          return;
+        }
+      }
+      held |= hand.ranks_with_at_least(1);
+    }
+    int n = 0;
+    for (int r = 0; r < Hand::RANK_BLACK_JOKER; r++) {
+      if (held >> r & 1) {
+        index[r] = n;
+        rank[n++] = r;
+      }
+    }
+    for (int r = Hand::RANK_BLACK_JOKER; r < Hand::RANK_NUM; r++) {
+      index[r] = rank[r] = r;
+    }
+  }
+
+  uint64_t key(const GameState &state) const {
+    if (!relative) {
+      return state.hash;
+    }
+    // Apart from the keys of GameState::hash
+    uint64_t z = Zobrist::key(2000) ^ Zobrist::LANDLORD[state.landlord] ^
+                 Zobrist::TURN[state.turn] ^
+                 Zobrist::LAST_PLAYER[state.last_player + 1];
+    for (int p = 0; p < 3; p++) {
+      for (uint16_t m = state.hands[p].ranks_with_at_least(1); m;
+           m &= m - 1) {
+        int r = std::countr_zero(m);
+        z ^= Zobrist::COUNT[p][index[r]][state.hands[p].count(r)];
+      }
+    }
+    const Move &last = state.last_play;
+    if (!last.is_none()) {
+      // A move beats the last play if its index is at least this, the
+      // kickers never matter
+      uint16_t below = held & ((2 << last.rank) - 1);
+      int least = last.rank >= Hand::RANK_BLACK_JOKER ? last.rank + 1
+                                                      : std::popcount(below);
+      z ^= Zobrist::last_play(Move(last.get_type_t(), least, last.length));
+    }
+    return z;
+  }
+
+  // The move as stored in the table, and back
+  Move to_relative(const Move &m) const { return map(m, index); }
+  Move to_absolute(const Move &m) const { return map(m, rank); }
+};
+
+} // namespace
+
+Solver::Solver(int table_bits)
+    : own_table(std::make_unique<TranspositionTable>(table_bits)),
+      table(own_table.get()), evaluator(18), nodes(0) {}
+
+Solver::Solver(TranspositionTable &shared)
+    : table(&shared), evaluator(18), nodes(0) {}
+
+void Solver::clear() { table->clear(); }
+
+Solver::Result Solver::solve(const GameState &state) {
+  assert(!state.is_over());
+  GameState s = state;
+  Move best = Move::none();
+  bool win = search(s, 0, best);
+  return {win, best};
+}
+
+bool Solver::is_unbeatable(const GameState &state, const Move &move,
+                           Arena &arena) {
+  for (int i = 1; i < 3; i++) {
+    int p = (state.turn + i) % 3;
+    // The partner can always pass
+    if (state.same_side(p, state.turn)) {
+      continue;
+    }
+    auto replies = Strategy::generate(state.hands[p], move, arena.get());
+    if (replies.begin() != replies.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Solver::plays_out(const GameState &state, const Hand &hand, int beatable,
+                       int depth) {
+  if (hand.empty()) {
+    return true;
+  }
+  if (depth == (int)arenas.size()) {
+    arenas.push_back(std::make_unique<Arena>(16 * 1024));
+  }
+  Arena &arena = *arenas[depth];
+  arena.reset();
+  // As in Evaluator, some play holds the lowest rank
+  uint64_t lowest = 0xFULL << (std::countr_zero(hand.get_counts()) & ~3);
+  for (const auto &m : Strategy::generate(hand, Move::none(), arena.get())) {
+    if ((m.counts() & lowest) == 0) {
+      continue;
+    }
+    int left = beatable - !is_unbeatable(state, m, arena);
+    if (left < 0) {
+      continue;
+    }
+    Hand rest = hand;
+    rest.remove(m);
+    if (plays_out(state, rest, left, depth + 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Solver::search(GameState &state, int depth, Move &best) {
+  nodes++;
+  if (depth == (int)arenas.size()) {
+    arenas.push_back(std::make_unique<Arena>(16 * 1024));
+  }
+  Arena &arena = *arenas[depth];
+  arena.reset();
+
+  const int player = state.turn;
+  const Hand &hand = state.hands[player];
+  std::pmr::vector<Move> moves =
+      Strategy::get_moves(hand, state.last_play, arena.get());
+  if (moves.empty()) {
+    // Nothing beats the last play: the pass is forced, and the position gets
+    // no entry of its own
+    auto undo = state.make_move(Move::none());
+    Move reply;
+    bool child_win = search(state, depth + 1, reply);
+    bool win = child_win == state.same_side(state.turn, player);
+    state.unmake_move(undo);
+    best = Move::none();
+    return win;
+  }
+
+  RankOrder order(state);
+  uint64_t key = order.key(state);
+  // Bit 0 marks the data as used, bit 1 is the result, then the move
+  uint64_t data;
+  if (table->probe(key, data)) {
+    best = order.to_absolute(Move::decode(data >> 2));
+    return data & 2;
+  }
+
+  bool win = false;
+  Move winning = Move::none();
+  std::pmr::vector<Candidate> candidates(arena.get());
+  candidates.reserve(moves.size() + 1);
+  for (const auto &m : moves) {
+    if (m.size() == hand.size()) {
+      win = true;
+      winning = m;
+      break;
+    }
+    Hand rest = hand;
+    rest.remove(m);
+    int plays = evaluator.min_plays(rest);
+    // Nobody can stop the player from playing out the rest: no opponent
+    // beats the move, nor any play of the rest but the last one
+    if (plays <= SPLIT_MAX && is_unbeatable(state, m, arena) &&
+        plays_out(state, rest, 1, depth + 1)) {
+      win = true;
+      winning = m;
+      break;
+    }
+    candidates.push_back({m, plays, false, 0});
+  }
+
+  if (!win) {
+    // Of the kicker variants of a move, the one leaving the fewest plays
+    // (the lowest kickers on ties) goes before all the other variants
+    for (size_t i = 0; i < candidates.size();) {
+      size_t first = i;
+      uint32_t cls = move_class(candidates[i].move);
+      for (; i < candidates.size() && move_class(candidates[i].move) == cls;
+           i++) {
+        if (candidates[i].plays < candidates[first].plays) {
+          first = i;
+        }
+      }
+      candidates[first].first = true;
+    }
+    if (state.can_pass()) {
+      // Do not beat the partner before trying to let it go on
+      bool partner = state.same_side(state.last_player, player);
+      candidates.push_back({Move::none(), 0, partner, 0});
+    }
+
+    // The fewest plays left first, then the largest moves, then the moves
+    // that won most often elsewhere
+    for (auto &c : candidates) {
+      // Bits: 62 first variant, [40, 48) fewer plays, [32, 40) size, then
+      // the history
+      if (!c.move.is_none()) {
+        c.key = (uint64_t)c.first << 62 | (uint64_t)(0xFF - c.plays) << 40 |
+                (uint64_t)c.move.size() << 32 |
+                std::min(history[player][history_index(c.move)],
+                         HISTORY_MAX - 1);
+      } else if (c.first) {
+        c.key = UINT64_MAX;
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &c1, const Candidate &c2) {
+                return c1.key != c2.key ? c1.key > c2.key
+                                        : c1.move.encode() < c2.move.encode();
+              });
+    for (const auto &c : candidates) {
+      auto undo = state.make_move(c.move);
+      Move reply;
+      bool child_win = search(state, depth + 1, reply);
+      bool same_side = state.same_side(state.turn, player);
+      state.unmake_move(undo);
+      if (same_side == child_win) {
+        win = true;
+        winning = c.move;
+        if (!c.move.is_none()) {
+          history[player][history_index(c.move)]++;
+        }
+        break;
+      }
+    }
+  }
+
+  table->store(key, (uint64_t)order.to_relative(winning).encode() << 2 |
+                       win << 1 | 1);
+  best = winning;
+  return win;
+}
@@ -0,0 +1,96 @@
+#ifndef SOLVER
+#define SOLVER
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Arena.h"
+#include "Evaluator.h"
+#include "GameState.h"
+#include "Move.h"
+#include "Random.h"
+#include "TranspositionTable.h"
+
+/**
+ * @brief Exact solver for positions where all three hands are known
+ * (double dummy).
+ *
+ * The two peasants play as one side. The search is an AND/OR search (alpha-
+ * beta with the values win/lose): the side to move wins if one of its moves
+ * (or passing) leads to a position won by its side. Solved positions are
+ * stored in a TranspositionTable keyed by GameState::hash, which depends on
+ * the rank counts of the hands (suits never matter for the result) and on the
+ * landlord (who decides the sides). Once no hand can make a sequence, the
+ * keys only depend on the order of the ranks held, so that more positions
+ * share an entry.
+ *
+ * Most of the work goes into ordering: the moves leaving the fewest plays
+ * (Evaluator::min_plays) go first, and of the kicker variants of a move only
+ * the best one goes before the other moves. A position is won at once when
+ * the player can play out with moves nobody beats but the last, and a forced
+ * pass is played without an entry of its own.
+ */
+class Solver {
+public:
+  struct Result {
+    // Whether the side of the player to move wins with best play
+    bool win;
+    // A winning move if win, Move::none() for a pass
+    Move move;
+  };
+
+private:
+  // Set when the solver owns its table
+  std::unique_ptr<TranspositionTable> own_table;
+  TranspositionTable *table;
+  // One arena per depth, as the move lists of all ancestors stay alive
+  std::vector<std::unique_ptr<Arena>> arenas;
+  // Lower bounds on the plays a hand needs, to order the moves and to find
+  // the hands that go out at once
+  Evaluator evaluator;
+  uint64_t nodes;
+  // How often a move was the winning one, per player, to try it earlier in
+  // the other positions (history heuristic)
+  int history[3][4096] = {};
+  static int history_index(const Move &m) {
+    return Random::mix(m.encode()) & 4095;
+  }
+
+  // No player of the other side can beat the move of the player to move
+  static bool is_unbeatable(const GameState &state, const Move &move,
+                            Arena &arena);
+
+  /**
+   * @brief Whether the player to move, leading, can play out the hand with
+   * at most beatable plays that the other side can beat (played last)
+   */
+  bool plays_out(const GameState &state, const Hand &hand, int beatable,
+                 int depth);
+
+  /**
+   * @return Whether the side of state.turn wins
+   */
+  bool search(GameState &state, int depth, Move &best);
+
+public:
+  /**
+   * @param table_bits The hash table has 2^table_bits entries of 16 bytes
+   */
+  explicit Solver(int table_bits = 20);
+  /**
+   * @brief Use a table shared with other solvers, possibly running in other
+   * threads, so that a position solved by one is known to all
+   */
+  explicit Solver(TranspositionTable &shared);
+
+  Result solve(const GameState &state);
+
+  // Forget every solved position, also for the solvers sharing the table
+  void clear();
+
+  // Positions searched since construction, for statistics
+  uint64_t get_nodes() const { return nodes; }
+};
+
+#endif // SOLVER
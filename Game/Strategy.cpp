@@ -1,373 +1,299 @@
-
 #include "Strategy.h"
 
-std::vector<std::vector<Card>>
-Strategy::get_consecutive_n_cards_set(const std::vector<Card> &current,
-                                      const int &n) {
-  std::vector<std::vector<Card>> ans;
-  // Temp vector for current available card set that can play
-  std::vector<Card> set;
+#include <array>
+#include <utility>
 
-  size_t index = 0;
-  size_t length = current.size();
-  while (index < length) {
-    if (has_consecutive_cards(current, index, n)) {
-      set = std::vector<Card>();
-      for (int i = 0; i < n; i++) {
-        set.push_back(current[index + i]);
-      }
-      ans.push_back(set);
-    }
+#include "Profile.h"
 
-    index = jump_to_next_number(current, index);
-  }
-  return ans;
-}
+namespace {
 
-std::vector<std::vector<Card>>
-Strategy::get_sequence(const std::vector<Card> &current,
-                       const int &consecutive_num, const int &length) {
-  std::vector<std::vector<Card>> ans;
-  std::vector<Card> temp;
-  for (size_t index = 0; index < current.size();
-       index = jump_to_next_number(current, index)) {
-    if (current[index] == Card(SPADE, 2) ||
-        current[index] == Card(BLACK_JOKER) ||
-        current[index] == Card(RED_JOKER)) {
-      break;
-    }
-    temp = std::vector<Card>();
-    size_t length_temp = 0;
-    size_t index_temp = index;
-    while (length_temp < length) {
-      size_t num_temp = 0;
-      size_t first = index_temp;
-      size_t second = first;
+using Moves = std::pmr::vector<Move>;
 
-      while (current[first] == current[second]) {
-        num_temp++;
-        second++;
-        if (num_temp == consecutive_num) {
-          temp.insert(temp.end(), current.begin() + first,
-                      current.begin() + second);
-          break;
-        }
-      }
-      if (num_temp != consecutive_num) {
-        break;
-      }
+int lowest_rank(uint16_t mask) { return std::countr_zero(mask); }
 
-      length_temp++;
-      index_temp = jump_to_next_number(current, index_temp);
-      if (current[first] != current[index_temp] - 1) {
-        break;
-      }
-    }
-    if (length_temp != length) {
-      temp.clear();
-    } else {
-      ans.push_back(temp);
-    }
-  }
-  return ans;
+constexpr bool is_sequence(type_t type) {
+  return type == SingleSeq || type == DoubleSeq || type == ThreeSeq;
 }
 
-std::vector<CardSet>
-Strategy::get_possible_move_by_type(const std::vector<Card> &current,
-                                    Type type) {
-  std::vector<CardSet> ans;
+constexpr bool is_airplane(type_t type) {
+  return type == Airplane_Single || type == Airplane_Pair;
+}
 
-  // Temp vector for current available card set that can play
-  std::vector<Card> set;
-  switch (type.get_type_t()) {
-  case Single: {
-    auto ret = get_consecutive_n_cards_set(current, 1);
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
-    }
-    break;
-  }
+// Longest airplanes that fit in a hand of 20 cards, by cards per wing
+constexpr int MAX_AIRPLANE_LENGTH[3] = {0, 20 / 4, 20 / 5};
 
-  case Double: {
-    auto ret = get_consecutive_n_cards_set(current, 2);
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
+// The ranks of mask chosen by index, bit i for the i-th lowest rank (pdep)
+uint16_t deposit(uint32_t index, uint16_t mask) {
+  uint16_t ans = 0;
+  for (; index; index >>= 1, mask &= mask - 1) {
+    if (index & 1) {
+      ans |= mask & -mask;
     }
-    break;
   }
+  return ans;
+}
 
-  case Triple: {
-    auto ret = get_consecutive_n_cards_set(current, 3);
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
+// The inverse of deposit: bit i if the i-th lowest rank of mask is in subset
+uint8_t extract(uint16_t subset, uint16_t mask) {
+  uint8_t ans = 0;
+  for (int i = 0; mask; mask &= mask - 1, i++) {
+    if (subset & mask & -mask) {
+      ans |= 1 << i;
     }
-    break;
   }
+  return ans;
+}
 
-  case SingleSeq: {
-    auto ret = get_sequence(current, 1, type.get_length());
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
-    }
-    break;
+/**
+ * @brief Call f for every subset of k ranks of mask, without allocating.
+ *
+ * Gosper's hack walks the k-bit numbers below 2^popcount(mask) in
+ * increasing order, and each is spread on the ranks of mask.
+ */
+template <typename F> void for_each_subset(uint16_t mask, int k, F &&f) {
+  int n = std::popcount(mask);
+  if (k > n) {
+    return;
   }
-
-  case DoubleSeq: {
-    auto ret = get_sequence(current, 2, type.get_length());
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
-    }
-    break;
+  if (k == 0) {
+    f((uint16_t)0);
+    return;
   }
-
-  case ThreeSeq: {
-    auto ret = get_sequence(current, 3, type.get_length());
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
-    }
-    break;
+  for (uint32_t c = (1U << k) - 1; c < 1U << n;) {
+    f(deposit(c, mask));
+    uint32_t low = c & -c;
+    uint32_t r = c + low;
+    c = (((r ^ c) >> 2) / low) | r;
   }
+}
 
-  case ThreeOne: {
-    auto three = get_consecutive_n_cards_set(current, 3);
-    auto one = get_consecutive_n_cards_set(current, 1);
-    for (const auto &t : three) {
-      for (const auto &o : one) {
-        if (t[0] == o[0])
-          continue;
-        std::vector<Card> temp;
-        temp.push_back(o[0]);
-        ans.push_back(CardSet(type, t, temp));
-      }
+// Airplanes of length l from start, with every choice of wings
+template <type_t T>
+void emit_airplane(const Hand &current, int start, int l, Moves &out) {
+  uint16_t base = ((1 << l) - 1) << start;
+  if constexpr (T == Airplane_Pair) {
+    for_each_subset(current.ranks_with_at_least(2) & ~base, l,
+                    [&](uint16_t s) { out.push_back(Move(T, start, l, s)); });
+  } else {
+    // l single cards, two of them can come from the same rank: d ranks
+    // give two cards and l - 2d ranks one
+    uint16_t ones = current.ranks_with_at_least(1) & ~base;
+    uint16_t twos = current.ranks_with_at_least(2) & ~base;
+    for (int d = 0; 2 * d <= l; d++) {
+      for_each_subset(ones, l - d, [&](uint16_t s) {
+        for_each_subset(s & twos, d, [&](uint16_t p) {
+          out.push_back(Move(T, start, l, s, extract(p, s)));
+        });
+      });
     }
-    break;
   }
+}
 
-  case ThreeTwo: {
-    auto three = get_consecutive_n_cards_set(current, 3);
-    auto two = get_consecutive_n_cards_set(current, 2);
-    for (const auto &t : three) {
-      for (const auto &o : two) {
-        if (t[0] == o[0])
-          continue;
-        std::vector<Card> temp;
-        temp.insert(temp.end(), o.begin(), o.end());
-        ans.push_back(CardSet(type, t, temp));
-      }
+/**
+ * @brief Append the moves of type T whose leading rank is in allowed.
+ *
+ * @tparam L The length of a sequence or airplane type, 0 for all lengths
+ */
+template <type_t T, int L>
+void emit(const Hand &current, uint16_t allowed, Moves &out) {
+  if constexpr (T == Single || T == Double || T == Triple || T == Bomb) {
+    constexpr int n = T == Bomb ? 4 : (int)T;
+    for (uint16_t m = current.ranks_with_at_least(n) & allowed; m;
+         m &= m - 1) {
+      out.push_back(Move(T, lowest_rank(m)));
     }
-    break;
-  }
-
-  case Four_Two_Pair: {
-    auto four = get_consecutive_n_cards_set(current, 4);
-    auto two = get_consecutive_n_cards_set(current, 2);
-    for (const auto &f : four) {
-      for (size_t t1 = 0; t1 < two.size(); t1++) {
-        for (size_t t2 = t1 + 1; t2 < two.size(); t2++) {
-          if (f[0] == two[t1][0] || f[0] == two[t2][0])
-            continue;
-          std::vector<Card> temp;
-          temp.insert(temp.end(), two[t1].begin(), two[t1].end());
-          temp.insert(temp.end(), two[t2].begin(), two[t2].end());
-          ans.push_back(CardSet(type, f, temp));
-        }
+  } else if constexpr (is_sequence(T) && L == 0) {
+    // All lengths in one pass
+    constexpr int n = (int)T - (int)SingleSeq + 1;
+    Sequence::for_each(current.ranks_with_at_least(n), n,
+                       [&](int start, int l) {
+                         out.push_back(Move(T, start, l));
+                       });
+  } else if constexpr (is_sequence(T)) {
+    // Only the windows of length L that start in allowed
+    constexpr int n = (int)T - (int)SingleSeq + 1;
+    uint16_t ranks = current.ranks_with_at_least(n);
+    for (const auto &w : Sequence::windows(n, L, lowest_rank(allowed))) {
+      if ((ranks & w.mask) == w.mask) {
+        out.push_back(Move(T, w.start, L));
       }
     }
-    break;
-  }
-
-  case Four_Two_Single: {
-    auto four = get_consecutive_n_cards_set(current, 4);
-    auto one = get_consecutive_n_cards_set(current, 1);
-    for (const auto &f : four) {
-      for (size_t o1 = 0; o1 < one.size(); o1++) {
-        for (size_t o2 = o1 + 1; o2 < one.size(); o2++) {
-          if (f[0] == one[o1][0] || f[0] == one[o2][0])
-            continue;
-          std::vector<Card> temp;
-          temp.insert(temp.end(), one[o1].begin(), one[o1].end());
-          temp.insert(temp.end(), one[o2].begin(), one[o2].end());
-          ans.push_back(CardSet(type, f, temp));
-        }
-      }
+  } else if constexpr (T == ThreeOne || T == ThreeTwo) {
+    constexpr int kicker = T == ThreeOne ? 1 : 2;
+    uint16_t one = current.ranks_with_at_least(kicker);
+    for (uint16_t t = current.ranks_with_at_least(3) & allowed; t;
+         t &= t - 1) {
+      int rank = lowest_rank(t);
+      for_each_subset(one & ~(1 << rank), 1, [&](uint16_t o) {
+        out.push_back(Move(T, rank, 1, o));
+      });
     }
-    break;
-  }
-
-  case Airplane_Single: {
-    auto three_two = get_sequence(current, 3, 2);
-    auto one = get_consecutive_n_cards_set(current, 1);
-    for (const auto &t : three_two) {
-      for (size_t o1 = 0; o1 < one.size(); o1++) {
-        for (size_t o2 = o1 + 1; o2 < one.size(); o2++) {
-          if (t[0] == one[o1][0] || t[0] == one[o2][0] || t[3] == one[o1][0] ||
-              t[3] == one[o2][0]) {
-            continue;
-          }
-          std::vector<Card> temp;
-          temp.insert(temp.end(), one[o1].begin(), one[o1].end());
-          temp.insert(temp.end(), one[o2].begin(), one[o2].end());
-          ans.push_back(CardSet(type, t, temp));
-        }
-      }
+  } else if constexpr (T == Four_Two_Single || T == Four_Two_Pair) {
+    constexpr int kicker = T == Four_Two_Single ? 1 : 2;
+    uint16_t one = current.ranks_with_at_least(kicker);
+    for (uint16_t f = current.ranks_with_at_least(4) & allowed; f;
+         f &= f - 1) {
+      int rank = lowest_rank(f);
+      for_each_subset(one & ~(1 << rank), 2, [&](uint16_t o) {
+        out.push_back(Move(T, rank, 1, o));
+      });
     }
-    auto two = get_consecutive_n_cards_set(current, 2);
-    for (const auto &t : three_two) {
-      for (size_t o1 = 0; o1 < two.size(); o1++) {
-        if (t[0] == two[o1][0] || t[3] == two[o1][0]) {
-          continue;
-        }
-        std::vector<Card> temp;
-        temp.insert(temp.end(), one[o1].begin(), one[o1].end());
-        ans.push_back(CardSet(type, t, temp));
+  } else if constexpr (is_airplane(T) && L == 0) {
+    constexpr int wing = T == Airplane_Single ? 1 : 2;
+    // The triples of an airplane are a 三顺
+    Sequence::for_each(
+        current.ranks_with_at_least(3), 3,
+        [&](int start, int l) { emit_airplane<T>(current, start, l, out); },
+        MAX_AIRPLANE_LENGTH[wing]);
+  } else if constexpr (is_airplane(T)) {
+    uint16_t triples = current.ranks_with_at_least(3);
+    for (const auto &w : Sequence::windows(3, L, lowest_rank(allowed))) {
+      if ((triples & w.mask) == w.mask) {
+        emit_airplane<T>(current, w.start, L, out);
       }
     }
-    break;
+  } else if constexpr (T == UltraBomb) {
+    if (current.count(Hand::RANK_BLACK_JOKER) &&
+        current.count(Hand::RANK_RED_JOKER)) {
+      out.push_back(Move::rocket());
+    }
   }
+}
+
+using Emitter = void (*)(const Hand &, uint16_t, Moves &);
+using EmitterRow = std::array<Emitter, Sequence::MAX_LENGTH + 1>;
 
-  case Airplane_Pair: {
-    auto three_two = get_sequence(current, 3, 2);
-    auto two = get_consecutive_n_cards_set(current, 2);
-    for (const auto &t : three_two) {
-      for (size_t o1 = 0; o1 < two.size(); o1++) {
-        for (size_t o2 = o1 + 1; o2 < two.size(); o2++) {
-          if (t[0] == two[o1][0] || t[0] == two[o2][0] || t[3] == two[o1][0] ||
-              t[3] == two[o2][0]) {
-            continue;
-          }
-          std::vector<Card> temp;
-          temp.insert(temp.end(), two[o1].begin(), two[o1].end());
-          temp.insert(temp.end(), two[o2].begin(), two[o2].end());
-          ans.push_back(CardSet(type, t, temp));
-        }
+// The length only matters to the sequences and airplanes, the others have
+// one emitter for all lengths
+template <type_t T> constexpr EmitterRow emitter_row() {
+  return []<size_t... L>(std::index_sequence<L...>) {
+    constexpr bool has_length = is_sequence(T) || is_airplane(T);
+    return EmitterRow{&emit<T, has_length ? (int)L : 0>...};
+  }(std::make_index_sequence<Sequence::MAX_LENGTH + 1>());
+}
+
+// EMITTERS[type][length], built at compile time
+constexpr std::array<EmitterRow, TYPE_END> EMITTERS =
+    []<size_t... T>(std::index_sequence<T...>) {
+      return std::array<EmitterRow, TYPE_END>{emitter_row<(type_t)T>()...};
+    }(std::make_index_sequence<TYPE_END>());
+
+// The types that can follow a type, in the order of generation
+struct Followers {
+  int count;
+  type_t types[TYPE_END];
+};
+
+constexpr std::array<Followers, TYPE_END> FOLLOWERS = []() {
+  std::array<Followers, TYPE_END> followers{};
+  for (int t = TYPE_START; t < TYPE_END; t++) {
+    Followers &f = followers[t];
+    if (t == TYPE_START) {
+      for (int u = TYPE_START + 1; u < TYPE_END; u++) {
+        f.types[f.count++] = (type_t)u;
       }
+      continue;
     }
-    break;
-  }
-
-  case Bomb: {
-    auto ret = get_consecutive_n_cards_set(current, 4);
-    for (const auto &r : ret) {
-      ans.push_back(CardSet(type, r));
+    if (t != Bomb && t != UltraBomb) {
+      f.types[f.count++] = (type_t)t;
     }
-    break;
-  }
-
-  case UltraBomb: {
-    if (current[current.size() - 1] == Card(RED_JOKER, -1) &&
-        current[current.size() - 2] == Card(BLACK_JOKER, -1)) {
-      set = std::vector<Card>(current.end() - 2, current.end());
-      ans.push_back(CardSet(type, set));
+    if (t != UltraBomb) {
+      f.types[f.count++] = Bomb;
+      f.types[f.count++] = UltraBomb;
     }
-    break;
   }
-  default:
-    break;
+  return followers;
+}();
+
+// The moves of one type, after a play of current_type with last_rank
+void emit(const Hand &current, type_t type, Type current_type, int last_rank,
+          Moves &out) {
+  Profile::TypeTimer timer(type);
+  size_t before = out.size();
+  // Ranks allowed for the leading rank of the move
+  uint16_t allowed = 0xFFFF;
+  int length = 0;
+  if (type == current_type.get_type_t()) {
+    allowed <<= last_rank + 1;
+    length = current_type.get_length();
   }
-  return ans;
+  EMITTERS[type][length](current, allowed, out);
+  timer.stop(out.size() - before);
 }
 
-size_t Strategy::jump_to_next_number(const std::vector<Card> &current,
-                                     size_t index) {
-  Card t = current[index];
-  while (t == current[index]) {
-    index++;
-    if (index == current.size())
-      return index;
+} // namespace
+
+Generator<Move> Strategy::generate(std::allocator_arg_t,
+                                   std::pmr::memory_resource *resource,
+                                   Hand current, Type current_type,
+                                   int last_rank) {
+  // One type at a time, so that a caller stopping early saves the others
+  const Followers &followers = FOLLOWERS[current_type.get_type_t()];
+  Moves moves(resource);
+  for (int i = 0; i < followers.count; i++) {
+    moves.clear();
+    emit(current, followers.types[i], current_type, last_rank, moves);
+    for (const Move &m : moves) {
+      co_yield m;
+    }
   }
-  return index;
 }
 
-bool Strategy::has_consecutive_cards(const std::vector<Card> &current,
-                                     size_t index, int num) {
-  for (int i = 0; i < num; i++) {
-    if (index + i == current.size())
-      return false;
-    if (current[index + i] != current[index])
-      return false;
+Generator<Move> Strategy::generate(const Hand &current,
+                                   const Move &last_play,
+                                   std::pmr::memory_resource *resource) {
+  if (last_play.is_none()) {
+    return generate(std::allocator_arg, resource, current, Type(TYPE_START),
+                    -1);
   }
-  return true;
+  return generate(std::allocator_arg, resource, current, last_play.get_type(),
+                  last_play.rank);
 }
 
-std::vector<Type> Strategy::get_possible_types(Type current_type) {
-  std::vector<Type> types;
-  switch (current_type.get_type_t()) {
-  case TYPE_START: {
-    type_t ptr = (type_t)((int)TYPE_START + 1);
-    while (ptr != TYPE_END) {
-      if (ptr == SingleSeq) {
-        for (int i = 5; i <= 12; i++) {
-          types.push_back(Type(ptr, i));
-        }
-      } else if (ptr == DoubleSeq) {
-        for (int i = 3; i <= 12; i++) {
-          types.push_back(Type(ptr, i));
-        }
-      } else if (ptr == ThreeSeq) {
-        for (int i = 2; i <= 12; i++) {
-          types.push_back(Type(ptr, i));
-        }
-      } else {
-        types.push_back(Type(ptr));
-      }
-      ptr = (type_t)((int)ptr + 1);
-    }
-    break;
+std::pmr::vector<Move> Strategy::get_moves(const Hand &current,
+                                           const Move &last_play,
+                                           std::pmr::memory_resource *resource) {
+  Profile::Scope scope(Profile::GET_MOVES);
+  Type type = last_play.is_none() ? Type(TYPE_START) : last_play.get_type();
+  int last_rank = last_play.is_none() ? -1 : last_play.rank;
+  const Followers &followers = FOLLOWERS[type.get_type_t()];
+  std::pmr::vector<Move> ans(resource);
+  for (int i = 0; i < followers.count; i++) {
+    emit(current, followers.types[i], type, last_rank, ans);
   }
-  case Single:
-  case Double:
-  case Triple:
-
-  case ThreeOne:
-  case ThreeTwo:
-
-  case SingleSeq:
-  case DoubleSeq:
-  case ThreeSeq:
-
-  case Airplane_Pair:
-  case Airplane_Single:
+  return ans;
+}
 
-  case Four_Two_Single:
-  case Four_Two_Pair: {
-    types.push_back(current_type);
-    types.push_back(Type(Bomb));
-    types.push_back(Type(UltraBomb));
-    break;
+std::vector<CardSet> Strategy::get_possible_move(const Hand &current,
+                                                 Type current_type) {
+  Profile::Scope scope(Profile::GET_POSSIBLE_MOVE);
+  std::vector<CardSet> ans;
+  for (const auto &move :
+       generate(std::allocator_arg, std::pmr::get_default_resource(), current,
+                current_type, -1)) {
+    ans.push_back(move.to_card_set(current));
   }
+  return ans;
+}
 
-  case Bomb: {
-    types.push_back(Type(Bomb));
-    types.push_back(Type(UltraBomb));
-    break;
-  }
-  case UltraBomb: {
-    break;
-  }
-  case TYPE_END: {
-    assert(0);
-  }
+std::vector<CardSet> Strategy::get_possible_move(const Hand &current,
+                                                 const CardSet &last_play) {
+  Profile::Scope scope(Profile::GET_POSSIBLE_MOVE);
+  std::vector<CardSet> ans;
+  for (const auto &move : generate(current, Move::from_card_set(last_play))) {
+    ans.push_back(move.to_card_set(current));
   }
-  return types;
+  return ans;
 }
 
 std::vector<CardSet> Strategy::get_possible_move(std::vector<Card> &current,
                                                  Type current_type) {
-  std::sort(current.begin(), current.end());
-
-  std::vector<CardSet> ans;
-
-  std::vector<Type> possible_types = get_possible_types(current_type);
-
-  for (const auto &p : possible_types) {
-    auto ret = get_possible_move_by_type(current, p);
-    ans.insert(ans.end(), ret.begin(), ret.end());
-  }
-  return ans;
+  return get_possible_move(Hand(current), current_type);
 }
 
 std::vector<CardSet> Strategy::trim_by_last_play(std::vector<CardSet> &current,
                                                  CardSet last_play) {
+  Profile::Scope scope(Profile::TRIM_BY_LAST_PLAY);
   std::vector<CardSet> ans;
   for (const auto &c : current) {
     if (last_play < c) {
@@ -375,4 +301,4 @@ std::vector<CardSet> Strategy::trim_by_last_play(std::vector<CardSet> &current,
     }
   }
   return ans;
-}
\ No newline at end of file
+}
@@ -1,42 +1,75 @@
 #ifndef STRATEGY
 #define STRATEGY
 
+#include <memory_resource>
 #include <vector>
 
 #include "Card.h"
+#include "Generator.h"
+#include "Hand.h"
+#include "Move.h"
+#include "Sequence.h"
 
 /**
  * @brief The class that determine different choices a player can take, given
  * the last played card set.
+ *
+ * Every type has its own generator, a template specialized at compile time
+ * on the type and, for the sequences and airplanes, on the length. A
+ * constexpr table maps a type and length to its generator, and another one
+ * the last play to the types that can follow it, so answering a play runs
+ * only the generator of its type, then the bomb and rocket ones.
+ *
+ * Moves are generated over rank counts only: plays that differ only in
+ * suits are the same Move and come out once, and no two moves of one call
+ * take the same count of every rank. The suits are chosen when a move is
+ * applied, always the lowest card ids of every rank (Hand::select), so the
+ * same move from the same hand always plays the same cards. The CardSet
+ * functions below follow the same rule through Move::to_card_set.
  */
 class Strategy {
 private:
-  static std::vector<std::vector<Card>>
-  get_consecutive_n_cards_set(const std::vector<Card> &current, const int &n);
+  /**
+   * @param resource Where the coroutine frame and temporaries are allocated
+   * @param last_rank Moves of the same type as current_type must have a
+   * leading rank higher than it, -1 for no limit
+   */
+  static Generator<Move> generate(std::allocator_arg_t,
+                                  std::pmr::memory_resource *resource,
+                                  Hand current, Type current_type,
+                                  int last_rank);
 
-  // number 2 and jokers are not included
-  static std::vector<std::vector<Card>>
-  get_sequence(const std::vector<Card> &current, const int &consecutive_num,
-               const int &length);
-
-  static std::vector<CardSet>
-  get_possible_move_by_type(const std::vector<Card> &current, Type type);
-
-  // return current.size() if index == current.size()
-  static size_t jump_to_next_number(const std::vector<Card> &current,
-                                    size_t index);
-
-  static bool has_consecutive_cards(const std::vector<Card> &current,
-                                    size_t index, int num);
+public:
+  /**
+   * @brief Lazily generate the moves that beat last_play, one by one.
+   *
+   * Nothing is built before it is asked for, so a search can stop at the
+   * first good move or count moves without storing them. The generator keeps
+   * its own copies of the arguments.
+   *
+   * @param resource Memory of the generator, usually an Arena reset once per
+   * turn or per search node, so that no call touches the global heap
+   */
+  static Generator<Move> generate(
+      const Hand &current, const Move &last_play,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-  static std::vector<Type> get_possible_types(Type current_type);
+  // All moves that beat last_play, allocated in resource
+  static std::pmr::vector<Move> get_moves(
+      const Hand &current, const Move &last_play,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
-public:
+  // All moves of the types allowed after current_type, of any rank
+  static std::vector<CardSet> get_possible_move(const Hand &current,
+                                                Type current_type);
   static std::vector<CardSet> get_possible_move(std::vector<Card> &current,
                                                 Type current_type);
+  // All moves that beat last_play, the same as trim_by_last_play on the above
+  static std::vector<CardSet> get_possible_move(const Hand &current,
+                                                const CardSet &last_play);
 
   static std::vector<CardSet> trim_by_last_play(std::vector<CardSet> &current,
                                                 CardSet last_play);
 };
 
-#endif // STRATEGY
\ No newline at end of file
+#endif // STRATEGY
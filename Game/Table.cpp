@@ -0,0 +1,80 @@
+#include "Table.h"
+
+#include "Deck.h"
+#include "Strategy.h"
+
+Table::Table(uint64_t seed, bid_rule_t _rule)
+    : rng(seed), rule(_rule), redeals(0), auction(0), playing(false) {
+  deal();
+}
+
+void Table::deal() {
+  Deal d = Deck(rng).deal();
+  for (int i = 0; i < 3; i++) {
+    hands[i] = d.hands[i];
+  }
+  landlord_cards = d.landlord_cards;
+  first_bidder = rng.bounded(3);
+  auction = Auction(first_bidder, rule);
+}
+
+bool Table::bid(int answer) {
+  if (playing || !auction.is_valid(answer)) {
+    return false;
+  }
+  auction.bid(answer);
+  if (!auction.is_done()) {
+    return true;
+  }
+
+  int landlord = auction.get_landlord();
+  if (landlord == -1) {
+    // Nobody wants to be the landlord
+    redeals++;
+    deal();
+    return true;
+  }
+  Hand start[3] = {hands[0], hands[1], hands[2]};
+  start[landlord] = Hand::from_cards(start[landlord].get_cards() |
+                                     landlord_cards.get_cards());
+  state = GameState(start, landlord);
+  playing = true;
+  return true;
+}
+
+void Table::pass_if_forced() {
+  while (!state.is_over() && state.can_pass()) {
+    auto moves = Strategy::generate(state.hands[state.turn], state.last_play);
+    if (moves.begin() != moves.end()) {
+      return;
+    }
+    state.make_move(Move::none());
+  }
+}
+
+bool Table::play(const Move &move) {
+  if (!playing || state.is_over()) {
+    return false;
+  }
+  if (move.is_none()) {
+    if (!state.can_pass()) {
+      return false;
+    }
+  } else {
+    // Only what the generator gives is legal, whatever the client sent
+    bool legal = false;
+    for (const auto &m :
+         Strategy::generate(state.hands[state.turn], state.last_play)) {
+      if (m == move) {
+        legal = true;
+        break;
+      }
+    }
+    if (!legal) {
+      return false;
+    }
+  }
+  state.make_move(move);
+  pass_if_forced();
+  return true;
+}
@@ -0,0 +1,76 @@
+#ifndef TABLE
+#define TABLE
+
+#include <cstdint>
+
+#include "Auction.h"
+#include "GameState.h"
+#include "Hand.h"
+#include "Random.h"
+
+/**
+ * @brief A whole game (deal, bidding and play) driven by the answers of its
+ * players, one at a time.
+ *
+ * Unlike Game, a table never calls its players: it says who has to answer
+ * and what, and waits for bid() or play(). This lets one thread run many
+ * tables whose players are remote and answer in any order. Answers are
+ * checked, since they come from outside.
+ */
+class Table {
+private:
+  Random rng;
+  bid_rule_t rule;
+  // The hands as dealt, before the landlord takes the landlord cards
+  Hand hands[3];
+  Hand landlord_cards;
+  int first_bidder;
+  // Deals thrown away because nobody wanted to be the landlord
+  uint32_t redeals;
+  Auction auction;
+  GameState state;
+  bool playing;
+
+  void deal();
+  // Players who can not beat the last play pass at once, as in Game
+  void pass_if_forced();
+
+public:
+  explicit Table(uint64_t seed, bid_rule_t _rule = RULE_ROB);
+
+  bool is_bidding() const { return !playing; }
+  bool is_over() const { return playing && state.is_over(); }
+
+  // The player to answer
+  int get_player() const {
+    return playing ? state.turn : auction.get_player();
+  }
+  // The stage of the bidding, only while is_bidding()
+  bid_stage_t get_stage() const { return auction.get_stage(); }
+  // BID_POINTS: the highest bid so far
+  int get_highest() const { return auction.get_highest(); }
+  // The first bidder and landlord cards of the current deal
+  int get_first_bidder() const { return first_bidder; }
+  const Hand &get_landlord_cards() const { return landlord_cards; }
+  uint32_t get_redeals() const { return redeals; }
+  // The current hand of a player
+  const Hand &get_hand(int player) const {
+    return playing ? state.hands[player] : hands[player];
+  }
+  // The play, only valid once the bidding is over
+  const GameState &get_state() const { return state; }
+
+  /**
+   * @param answer 1 for yes, 0 for no, or the points for BID_POINTS
+   * @return false if the answer is not valid, nothing changes then
+   */
+  bool bid(int answer);
+
+  /**
+   * @param move The move of get_player(), Move::none() to pass
+   * @return false if the move is not legal, nothing changes then
+   */
+  bool play(const Move &move);
+};
+
+#endif // TABLE
@@ -0,0 +1,267 @@
+#include "TrainingData.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include "Arena.h"
+#include "GameState.h"
+#include "Strategy.h"
+
+namespace {
+
+// Every card of the deck, in the layout of Hand::get_counts()
+const uint64_t ALL_COUNTS = Hand::from_cards((1ULL << 54) - 1).get_counts();
+
+template <typename T> void put(std::byte *out, size_t offset, T value) {
+  std::memcpy(out + offset, &value, sizeof(T));
+}
+
+// 15 bytes, one per rank
+void put_counts(uint8_t *out, uint64_t counts) {
+  for (int r = 0; r < Hand::RANK_NUM; r++) {
+    out[r] = counts >> (4 * r) & 0xF;
+  }
+}
+
+} // namespace
+
+size_t TrainingFormat::serialize(const GameRecord &record,
+                                 std::vector<std::byte> &out, Arena &arena) {
+  assert(record.landlord >= 0 && record.winner >= 0);
+  int landlord = record.landlord;
+  Hand hands[3];
+  for (int i = 0; i < 3; i++) {
+    uint64_t cards = record.hands[i];
+    if (i == landlord) {
+      cards |= record.landlord_cards;
+    }
+    hands[i] = Hand::from_cards(cards);
+  }
+  // Suits are chosen by Hand::select as in the game, so the replay removes
+  // the same cards
+  GameState state(hands, landlord);
+  uint64_t played[3] = {0, 0, 0};
+  uint64_t shown = record.landlord_cards;
+  // The last two turns, the latest first
+  Move history[2] = {Move::none(), Move::none()};
+  bool passed[2] = {false, false};
+
+  size_t samples = 0;
+  for (size_t i = 0; i < record.moves.size(); i++) {
+    const Move &move = record.moves[i];
+    int player = state.turn;
+    arena.reset();
+    std::pmr::vector<Move> legal =
+        Strategy::get_moves(state.hands[player], state.last_play, arena.get());
+    if (state.can_pass()) {
+      legal.push_back(Move::none());
+    }
+    assert(std::find(legal.begin(), legal.end(), move) != legal.end() &&
+           "The record does not follow the rules");
+
+    if (legal.size() >= 2) {
+      assert(legal.size() <= UINT16_MAX);
+      size_t start = out.size();
+      size_t size = sample_size(legal.size());
+      // Padding and unused features are zero
+      out.resize(start + size, std::byte{0});
+      std::byte *sample = out.data() + start;
+      put<uint32_t>(sample, 0, size);
+      put<uint16_t>(sample, 4, legal.size());
+      put<uint8_t>(sample, 6, player);
+      put<uint8_t>(sample, 7,
+                   (player == landlord) == (record.winner == landlord));
+      put<uint32_t>(sample, 8, move.encode());
+      put<uint16_t>(sample, 12, i);
+      put<uint64_t>(sample, 16, record.seed);
+      for (size_t j = 0; j < legal.size(); j++) {
+        put<uint32_t>(sample, SAMPLE_HEADER_SIZE + FEATURE_SIZE + 4 * j,
+                      legal[j].encode());
+      }
+
+      uint8_t *f = (uint8_t *)(sample + SAMPLE_HEADER_SIZE);
+      auto seat = [&](int p) { return (p - player + 3) % 3; };
+      uint64_t own = state.hands[player].get_counts();
+      put_counts(f + OWN_HAND, own);
+      put_counts(f + UNSEEN,
+                 ALL_COUNTS - own - played[0] - played[1] - played[2]);
+      put_counts(f + SHOWN, Hand::from_cards(shown).get_counts());
+      for (int p = 0; p < 3; p++) {
+        put_counts(f + PLAYED + 15 * seat(p), played[p]);
+        f[HAND_SIZE + seat(p)] = state.hands[p].size();
+      }
+      if (!state.last_play.is_none()) {
+        put_counts(f + LAST_PLAY, state.last_play.counts());
+        f[LAST_TYPE] = state.last_play.type;
+        f[LAST_LENGTH] = state.last_play.length;
+        f[LAST_SEAT] = seat(state.last_player);
+      }
+      for (int k = 0; k < 2; k++) {
+        if (!history[k].is_none()) {
+          put_counts(f + HISTORY + 15 * k, history[k].counts());
+        }
+      }
+      f[ROLE] = seat(landlord);
+      f[PASSES] = passed[0] | passed[1] << 1;
+      samples++;
+    }
+
+    GameState::Undo undo = state.make_move(move);
+    if (!move.is_none()) {
+      played[player] += move.counts();
+      if (player == landlord) {
+        shown &= ~undo.cards;
+      }
+    }
+    history[1] = history[0];
+    passed[1] = passed[0];
+    history[0] = move;
+    passed[0] = move.is_none();
+  }
+  assert(state.winner() == record.winner);
+  return samples;
+}
+
+TrainingWriter::TrainingWriter(const std::string &_prefix, size_t _shard_size,
+                               size_t _capacity)
+    : prefix(_prefix), shard_size(_shard_size), capacity(_capacity) {
+  if (!open_shard()) {
+    throw std::runtime_error(error);
+  }
+  thread = std::thread(&TrainingWriter::run, this);
+}
+
+TrainingWriter::~TrainingWriter() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+  }
+}
+
+bool TrainingWriter::open_shard() {
+  if (file) {
+    std::fclose(file);
+  }
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "-%05d.ddzt", shard_num);
+  std::string path = prefix + suffix;
+  file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    error = "Can not open " + path;
+    return false;
+  }
+  // Fewer and larger writes than the default buffer
+  std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+  shard_num++;
+
+  std::byte header[TrainingFormat::FILE_HEADER_SIZE];
+  std::memcpy(header, TrainingFormat::MAGIC, 4);
+  put<uint32_t>(header, 4, TrainingFormat::VERSION);
+  put<uint32_t>(header, 8, TrainingFormat::FEATURE_SIZE);
+  put<uint32_t>(header, 12, TrainingFormat::SAMPLE_HEADER_SIZE);
+  std::fwrite(header, 1, sizeof(header), file);
+  shard_bytes = sizeof(header);
+  bytes += sizeof(header);
+  return true;
+}
+
+void TrainingWriter::write_block(const Block &block) {
+  if (!error.empty()) {
+    return;
+  }
+  // A game is never split between two shards
+  if (shard_bytes > TrainingFormat::FILE_HEADER_SIZE &&
+      shard_bytes + block.size() > shard_size && !open_shard()) {
+    return;
+  }
+  if (std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+    error = "Can not write shard " + std::to_string(shard_num - 1) + " of " +
+            prefix;
+    return;
+  }
+  shard_bytes += block.size();
+  bytes += block.size();
+}
+
+void TrainingWriter::run() {
+  std::vector<Block> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      not_empty.wait(guard, [&] { return !queue.empty() || closing; });
+      if (queue.empty()) {
+        return;
+      }
+      // Take everything at once, the producers go on with an empty queue
+      batch.swap(queue);
+    }
+    size_t written = 0;
+    for (const Block &block : batch) {
+      write_block(block);
+      written += block.size();
+    }
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      queued_bytes -= written;
+      for (Block &block : batch) {
+        block.clear();
+        free_blocks.push_back(std::move(block));
+      }
+    }
+    batch.clear();
+    not_full.notify_all();
+  }
+}
+
+void TrainingWriter::write(const GameRecord &record) {
+  // Each thread keeps its own arena and block, so that building the samples
+  // needs neither the lock nor, once warm, an allocation
+  thread_local Arena arena;
+  thread_local Block local;
+  local.clear();
+  size_t n = TrainingFormat::serialize(record, local, arena);
+  if (n == 0) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> guard(lock);
+  assert(!closing && "Write after close");
+  // A block larger than the capacity still goes into an empty queue
+  if (queued_bytes > 0 && queued_bytes + local.size() > capacity) {
+    stalls++;
+    not_full.wait(guard, [&] {
+      return queued_bytes == 0 || queued_bytes + local.size() <= capacity;
+    });
+  }
+  queued_bytes += local.size();
+  samples += n;
+  queue.push_back(std::move(local));
+  local = Block();
+  if (!free_blocks.empty()) {
+    local.swap(free_blocks.back());
+    free_blocks.pop_back();
+  }
+  guard.unlock();
+  not_empty.notify_one();
+}
+
+void TrainingWriter::close() {
+  if (thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      closing = true;
+    }
+    not_empty.notify_one();
+    thread.join();
+    if (file && std::fclose(file) != 0 && error.empty()) {
+      error = "Can not close shard " + std::to_string(shard_num - 1) +
+              " of " + prefix;
+    }
+    file = nullptr;
+  }
+  if (!error.empty()) {
+    throw std::runtime_error(error);
+  }
+}
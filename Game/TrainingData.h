@@ -0,0 +1,165 @@
+#ifndef TRAINING_DATA
+#define TRAINING_DATA
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameRecord.h"
+
+class Arena;
+
+/**
+ * @brief Training samples for policy and value models, one per decision of
+ * a game.
+ *
+ * A decision is a turn with at least two legal choices, passing included.
+ * Every sample is, in native byte order and padded to 8 bytes:
+ *
+ *   offset  size  field
+ *        0     4  sample size in bytes, padding included
+ *        4     2  number of legal moves
+ *        6     1  player to move
+ *        7     1  outcome: 1 if the side of the player won the game, else 0
+ *        8     4  chosen move, Move::encode(), Move::none() to pass
+ *       12     2  index of the turn in GameRecord::moves
+ *       14     2  zero
+ *       16     8  seed of the game
+ *       24   144  features, FEATURE_SIZE bytes, see below
+ *      168        legal moves, Move::encode() on 4 bytes each, in the order
+ *                 of Strategy::get_moves, then Move::none() if passing is
+ *                 allowed
+ *
+ * The features are a fixed-width vector of bytes, from the point of view of
+ * the player to move: only what the player can know. Rank counts are 15
+ * bytes in the order of Card::get_rank, and seats are relative to the
+ * player: 0 the player, 1 the next one, 2 the one before.
+ */
+namespace TrainingFormat {
+
+constexpr char MAGIC[4] = {'D', 'D', 'Z', 'T'};
+constexpr uint32_t VERSION = 1;
+// Magic, version, feature size and sample header size, 4 bytes each
+constexpr size_t FILE_HEADER_SIZE = 16;
+constexpr size_t SAMPLE_HEADER_SIZE = 24;
+
+// Offsets in the features
+constexpr int OWN_HAND = 0;    // Rank counts of the hand of the player
+constexpr int UNSEEN = 15;     // Rank counts in the two other hands
+constexpr int SHOWN = 30;      // Landlord cards the landlord still holds
+constexpr int PLAYED = 45;     // Rank counts played, 15 for every seat
+constexpr int LAST_PLAY = 90;  // The play to beat, zero when leading
+constexpr int HISTORY = 105;   // The plays of seats 2 and 1, zero for a pass
+constexpr int HAND_SIZE = 135; // Cards left, 1 for every seat
+constexpr int ROLE = 138;      // Seat of the landlord
+constexpr int LAST_TYPE = 139; // type_t of the play to beat
+constexpr int LAST_LENGTH = 140;
+constexpr int LAST_SEAT = 141; // Seat of who made it, 0 when leading
+constexpr int PASSES = 142;    // Bit 0 if seat 2 passed its turn, bit 1 seat 1
+constexpr int FEATURE_SIZE = 144;
+
+constexpr size_t sample_size(size_t legal_num) {
+  return (SAMPLE_HEADER_SIZE + FEATURE_SIZE + 4 * legal_num + 7) & ~7;
+}
+
+/**
+ * @brief Replay the game and append a sample for every decision to out
+ *
+ * @param arena Memory of the move generation, reset at every turn
+ * @return Number of samples
+ */
+size_t serialize(const GameRecord &record, std::vector<std::byte> &out,
+                 Arena &arena);
+
+} // namespace TrainingFormat
+
+/**
+ * @brief Write training samples to sharded files from any number of
+ * simulation threads.
+ *
+ * The samples of a game are built by the calling thread, then the whole
+ * block is moved into a queue bounded in bytes. A writer thread of its own
+ * takes everything queued at once and writes it, so the simulation threads
+ * never touch the disk. They only wait when the queue is full, which is when
+ * the disk can not keep up (backpressure): memory stays bounded and the wait
+ * is counted in get_stalls(). Written blocks go back to a free list, so that
+ * the queue allocates nothing once warm.
+ *
+ * The files are prefix-00000.ddzt, prefix-00001.ddzt, ..., each with a file
+ * header and whole games, and a new one is started when one exceeds the
+ * shard size.
+ */
+class TrainingWriter {
+private:
+  using Block = std::vector<std::byte>;
+
+  std::string prefix;
+  size_t shard_size;
+  size_t capacity;
+
+  // Shared with the writer thread, under lock
+  std::mutex lock;
+  std::condition_variable not_empty;
+  std::condition_variable not_full;
+  std::vector<Block> queue;
+  std::vector<Block> free_blocks;
+  // Bytes queued or being written
+  size_t queued_bytes = 0;
+  bool closing = false;
+  uint64_t stalls = 0;
+  uint64_t samples = 0;
+
+  // Writer thread only
+  std::string error;
+  std::FILE *file = nullptr;
+  int shard_num = 0;
+  size_t shard_bytes = 0;
+  uint64_t bytes = 0;
+
+  std::thread thread;
+
+  // Close the current shard and start the next one
+  bool open_shard();
+  void write_block(const Block &block);
+  void run();
+
+public:
+  static constexpr size_t DEFAULT_SHARD_SIZE = 256 << 20;
+  static constexpr size_t DEFAULT_CAPACITY = 64 << 20;
+
+  /**
+   * @brief Create the first shard and start the writer thread, throws
+   * std::runtime_error if the shard can not be created
+   *
+   * @param _capacity Bytes the queue holds before the simulation threads wait
+   */
+  explicit TrainingWriter(const std::string &_prefix,
+                          size_t _shard_size = DEFAULT_SHARD_SIZE,
+                          size_t _capacity = DEFAULT_CAPACITY);
+  TrainingWriter(const TrainingWriter &) = delete;
+  TrainingWriter &operator=(const TrainingWriter &) = delete;
+  // Same as close(), without throwing
+  ~TrainingWriter();
+
+  // The samples of one finished game
+  void write(const GameRecord &record);
+  /**
+   * @brief Write everything queued, stop the writer thread and close the
+   * last shard, throws std::runtime_error if a shard could not be written
+   */
+  void close();
+
+  // Exact once closed
+  uint64_t get_samples() const { return samples; }
+  uint64_t get_bytes() const { return bytes; }
+  int get_shard_num() const { return shard_num; }
+  // Times a simulation thread waited for room in the queue
+  uint64_t get_stalls() const { return stalls; }
+};
+
+#endif // TRAINING_DATA
@@ -0,0 +1,13 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(int bits)
+    : slots(new Slot[1ULL << bits]), mask((1ULL << bits) - 1) {
+  clear();
+}
+
+void TranspositionTable::clear() {
+  for (uint64_t i = 0; i <= mask; i++) {
+    slots[i].check.store(0, std::memory_order_relaxed);
+    slots[i].data.store(0, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef TRANSPOSITION_TABLE
+#define TRANSPOSITION_TABLE
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Hash table of searched positions that many threads can read and
+ * write at the same time without locks.
+ *
+ * Every slot holds two 64-bit words, the data and (key XOR data), written and
+ * read with relaxed atomics. When two threads write the same slot at once, a
+ * reader can see the words of different writes. The XOR check then fails, and
+ * the torn slot looks empty instead of giving wrong data (Hyatt's lockless
+ * hashing). A newer store always replaces the slot.
+ *
+ * Keys are full 64-bit hashes (GameState::hash), the low bits select the
+ * slot. GameState::hash covers the rank counts of the three hands, the
+ * landlord, the player to move, the last player and the last play, so a
+ * table can be shared between solves of different deals and landlords.
+ */
+class TranspositionTable {
+private:
+  struct Slot {
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+  };
+
+  std::unique_ptr<Slot[]> slots;
+  uint64_t mask;
+
+public:
+  /**
+   * @param bits The table has 2^bits slots of 16 bytes
+   */
+  explicit TranspositionTable(int bits);
+
+  /**
+   * @brief Look for the data stored with key
+   *
+   * @return false if there is none (never stored, replaced, or torn)
+   */
+  bool probe(uint64_t key, uint64_t &data) const {
+    const Slot &slot = slots[key & mask];
+    uint64_t d = slot.data.load(std::memory_order_relaxed);
+    uint64_t c = slot.check.load(std::memory_order_relaxed);
+    // 0 is the data of an empty slot
+    if (d == 0 || (c ^ d) != key) {
+      return false;
+    }
+    data = d;
+    return true;
+  }
+
+  /**
+   * @param data Must not be 0
+   */
+  void store(uint64_t key, uint64_t data) {
+    Slot &slot = slots[key & mask];
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+  }
+
+  // Empty every slot, not to be called during a search
+  void clear();
+};
+
+#endif // TRANSPOSITION_TABLE
@@ -0,0 +1,45 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+WorkStealingPool::WorkStealingPool(int _thread_num)
+    : thread_num(_thread_num), workers(new Worker[_thread_num]) {
+  assert(thread_num > 0);
+}
+
+bool WorkStealingPool::pop(int id, size_t grain, size_t &begin, size_t &end) {
+  Worker &w = workers[id];
+  std::lock_guard<std::mutex> guard(w.lock);
+  if (w.begin == w.end) {
+    return false;
+  }
+  begin = w.begin;
+  end = std::min(w.end, w.begin + grain);
+  w.begin = end;
+  return true;
+}
+
+bool WorkStealingPool::steal(int id) {
+  // Try the victims in a different order for every thief
+  for (int k = 1; k < thread_num; k++) {
+    Worker &victim = workers[(id + k) % thread_num];
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> guard(victim.lock);
+      size_t left = victim.end - victim.begin;
+      if (left < 2) {
+        continue;
+      }
+      begin = victim.end - left / 2;
+      end = victim.end;
+      victim.end = begin;
+    }
+    Worker &w = workers[id];
+    std::lock_guard<std::mutex> guard(w.lock);
+    w.begin = begin;
+    w.end = end;
+    return true;
+  }
+  return false;
+}
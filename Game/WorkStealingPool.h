@@ -0,0 +1,81 @@
+#ifndef WORK_STEALING_POOL
+#define WORK_STEALING_POOL
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Run a batch of independent tasks on several threads.
+ *
+ * Every worker owns a range of task indices and takes small chunks from its
+ * front. A worker whose range is empty steals the back half of the range of
+ * another worker, so that threads finishing early keep busy when some tasks
+ * (games) are much longer than others.
+ */
+class WorkStealingPool {
+private:
+  // Half-open range [begin, end) of task indices
+  struct alignas(64) Worker {
+    std::mutex lock;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  int thread_num;
+  std::unique_ptr<Worker[]> workers;
+
+  // Take at most grain tasks from the front of its own range
+  bool pop(int id, size_t grain, size_t &begin, size_t &end);
+  // Move the back half of the range of another worker to its own range
+  bool steal(int id);
+
+public:
+  explicit WorkStealingPool(int _thread_num);
+
+  int get_thread_num() const { return thread_num; }
+
+  /**
+   * @brief Call task(thread_id, index) for every index in [0, n), and return
+   * when all of them are done.
+   *
+   * @param grain Number of tasks taken by a worker at once
+   */
+  template <typename Task>
+  void parallel_for(size_t n, size_t grain, Task &&task);
+};
+
+template <typename Task>
+void WorkStealingPool::parallel_for(size_t n, size_t grain, Task &&task) {
+  for (int i = 0; i < thread_num; i++) {
+    workers[i].begin = n * i / thread_num;
+    workers[i].end = n * (i + 1) / thread_num;
+  }
+
+  auto work = [&](int id) {
+    size_t begin, end;
+    while (true) {
+      while (pop(id, grain, begin, end)) {
+        for (size_t i = begin; i < end; i++) {
+          task(id, i);
+        }
+      }
+      if (!steal(id)) {
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_num; i++) {
+    threads.emplace_back(work, i);
+  }
+  work(0);
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+#endif // WORK_STEALING_POOL
@@ -0,0 +1,88 @@
+#ifndef ZOBRIST
+#define ZOBRIST
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "Hand.h"
+#include "Move.h"
+
+/**
+ * @brief Compile-time random keys for Zobrist hashing of a GameState.
+ *
+ * The hash of a position is the XOR of one key per (player, rank, count), one
+ * for the landlord, one for the player to move, one for the last player and
+ * one for the last play.
+ * Changing one part of the position only XORs its old key out and its new key
+ * in, so the hash follows the position in O(1) per touched rank.
+ *
+ * Only rank counts are hashed: suits never matter for the play.
+ */
+namespace Zobrist {
+
+// splitmix64, so the keys do not depend on any runtime generator
+constexpr uint64_t key(uint64_t i) {
+  uint64_t z = (i + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// COUNT[player][rank][count], a count of 0 has the key 0 so that empty hands
+// hash to 0
+constexpr std::array<std::array<std::array<uint64_t, 5>, Hand::RANK_NUM>, 3>
+    COUNT = []() {
+      std::array<std::array<std::array<uint64_t, 5>, Hand::RANK_NUM>, 3>
+          table{};
+      uint64_t i = 0;
+      for (auto &player : table) {
+        for (auto &rank : player) {
+          for (int c = 1; c < 5; c++) {
+            rank[c] = key(i++);
+          }
+        }
+      }
+      return table;
+    }();
+
+constexpr uint64_t TURN[3] = {key(1000), key(1001), key(1002)};
+// The landlord decides the sides, so who wins, it never changes during play
+constexpr uint64_t LANDLORD[3] = {key(1006), key(1007), key(1008)};
+// Indexed by last_player + 1, leading (-1) has the key 0
+constexpr uint64_t LAST_PLAYER[4] = {0, key(1003), key(1004), key(1005)};
+
+inline uint64_t last_play(const Move &move) {
+  // Too many different moves for a table, the encoding is hashed instead
+  return move.is_none() ? 0 : key(move.encode() ^ 0x5A5A5A5A00000000ULL);
+}
+
+// The keys of all the counts of a hand
+inline uint64_t hand(int player, const Hand &h) {
+  uint64_t z = 0;
+  for (int r = 0; r < Hand::RANK_NUM; r++) {
+    z ^= COUNT[player][r][h.count(r)];
+  }
+  return z;
+}
+
+/**
+ * @brief The change of hand(player, h) when the cards of move are removed
+ * from h, only the ranks of the move are visited
+ */
+inline uint64_t remove(int player, const Hand &h, const Move &move) {
+  uint64_t z = 0;
+  uint64_t counts = move.counts();
+  while (counts) {
+    int r = std::countr_zero(counts) / 4;
+    int removed = counts >> (4 * r) & 0xF;
+    z ^= COUNT[player][r][h.count(r)];
+    z ^= COUNT[player][r][h.count(r) - removed];
+    counts &= ~(0xFULL << (4 * r));
+  }
+  return z;
+}
+
+} // namespace Zobrist
+
+#endif // ZOBRIST
@@ -0,0 +1,250 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "Arena.h"
+#include "Bidding.h"
+#include "Deck.h"
+#include "HandBatch.h"
+#include "Random.h"
+#include "Strategy.h"
+
+using namespace std;
+
+// Count every allocation of the benchmark, to report allocations per call
+static uint64_t allocation_count = 0;
+
+void *operator new(size_t size) {
+  allocation_count++;
+  if (void *p = malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+namespace {
+
+struct Result {
+  string name;
+  type_t type;
+  uint64_t calls;
+  uint64_t moves;
+  uint64_t allocations;
+  double seconds;
+
+  double ns_per_call() const { return seconds * 1e9 / calls; }
+  double moves_per_sec() const { return moves / seconds; }
+  double allocations_per_call() const { return (double)allocations / calls; }
+};
+
+/**
+ * @brief Hands as they appear during a game: full deals, the landlord's 20
+ * cards, and hands after some cards are played
+ */
+vector<Hand> make_corpus(uint64_t seed, int size) {
+  Random rng(seed);
+  vector<Hand> corpus;
+  while ((int)corpus.size() < size) {
+    Deal deal = Deck(rng).deal();
+    Hand landlord = Hand::from_cards(deal.hands[0].get_cards() |
+                                     deal.landlord_cards.get_cards());
+    corpus.push_back(landlord);
+    corpus.push_back(deal.hands[1]);
+    // Drop random cards until 1 to 16 are left
+    vector<Card> cards = deal.hands[2].to_vector();
+    int left = 1 + rng.bounded(16);
+    while ((int)cards.size() > left) {
+      cards.erase(cards.begin() + rng.bounded(cards.size()));
+    }
+    corpus.push_back(Hand(cards));
+  }
+  corpus.resize(size);
+  return corpus;
+}
+
+// The smallest play of the type, so that most moves of the type beat it
+CardSet make_last_play(type_t type) {
+  if (type == TYPE_START) {
+    return CardSet(TYPE_START, {});
+  }
+  Type t = type == SingleSeq         ? Type(type, 5)
+           : type == DoubleSeq       ? Type(type, 3)
+           : type == ThreeSeq        ? Type(type, 2)
+           : type == Airplane_Single ? Type(type, 2)
+           : type == Airplane_Pair   ? Type(type, 2)
+                                     : Type(type);
+  vector<Card> deck;
+  for (int i = 0; i < 54; i++) {
+    deck.push_back(Card(i));
+  }
+  for (const auto &move : Strategy::get_possible_move(Hand(deck), TYPE_START)) {
+    if (move.get_type() == t) {
+      return move;
+    }
+  }
+  assert(0 && "Should not reach here.");
+  return CardSet(TYPE_START, {});
+}
+
+template <typename Func>
+Result measure(const string &name, type_t type, double min_time, Func &&f) {
+  Result r{name, type, 0, 0, 0, 0};
+  auto start = chrono::steady_clock::now();
+  uint64_t allocations = allocation_count;
+  do {
+    r.moves += f();
+    r.calls++;
+    // Do not read the clock on every call
+    if (r.calls % 256 == 0) {
+      r.seconds = chrono::duration<double>(chrono::steady_clock::now() - start)
+                      .count();
+    }
+  } while (r.calls % 256 != 0 || r.seconds < min_time);
+  r.allocations = allocation_count - allocations;
+  return r;
+}
+
+void write_json(const string &path, uint64_t seed, int corpus_size,
+                const vector<Result> &results) {
+  ofstream out(path);
+  out << "{\n  \"seed\": " << seed << ",\n  \"corpus\": " << corpus_size
+      << ",\n  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &r = results[i];
+    out << "    {\"name\": \"" << r.name << "\", \"type\": \""
+        << type_name(r.type) << "\", \"calls\": " << r.calls
+        << ", \"ns_per_call\": " << r.ns_per_call()
+        << ", \"moves_per_sec\": " << r.moves_per_sec()
+        << ", \"allocations_per_call\": " << r.allocations_per_call() << "}"
+        << (i + 1 == results.size() ? "\n" : ",\n");
+  }
+  out << "  ]\n}\n";
+}
+
+void usage(const char *name) {
+  cerr << "Usage: " << name
+       << " [--seed n] [--hands n] [--min-time seconds] [--json path]\n";
+  exit(1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  uint64_t seed = 2022;
+  int corpus_size = 3000;
+  double min_time = 0.2;
+  string json_path;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 == argc) {
+      usage(argv[0]);
+    }
+    if (arg == "--seed") {
+      seed = stoull(argv[++i]);
+    } else if (arg == "--hands") {
+      corpus_size = stoi(argv[++i]);
+    } else if (arg == "--min-time") {
+      min_time = stod(argv[++i]);
+    } else if (arg == "--json") {
+      json_path = argv[++i];
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (corpus_size < 1) {
+    usage(argv[0]);
+  }
+
+  vector<Hand> corpus = make_corpus(seed, corpus_size);
+  vector<Result> results;
+  Arena arena;
+
+  for (int t = TYPE_START; t < TYPE_END; t++) {
+    type_t type = (type_t)t;
+    CardSet last_play = make_last_play(type);
+
+    size_t index = 0;
+    results.push_back(
+        measure("get_possible_move", type, min_time, [&]() -> size_t {
+          const Hand &hand = corpus[index++ % corpus.size()];
+          return Strategy::get_possible_move(hand, last_play.get_type())
+              .size();
+        }));
+
+    Move last_move = Move::from_card_set(last_play);
+    index = 0;
+    results.push_back(measure("generate", type, min_time, [&]() -> size_t {
+      const Hand &hand = corpus[index++ % corpus.size()];
+      arena.reset();
+      size_t n = 0;
+      auto moves = Strategy::generate(hand, last_move, arena.get());
+      for (auto it = moves.begin(); it != moves.end(); ++it) {
+        n++;
+      }
+      return n;
+    }));
+
+    index = 0;
+    results.push_back(measure("get_moves", type, min_time, [&]() -> size_t {
+      const Hand &hand = corpus[index++ % corpus.size()];
+      arena.reset();
+      return Strategy::get_moves(hand, last_move, arena.get()).size();
+    }));
+
+    vector<vector<CardSet>> moves;
+    for (const auto &hand : corpus) {
+      moves.push_back(Strategy::get_possible_move(hand, last_play.get_type()));
+    }
+    index = 0;
+    results.push_back(
+        measure("trim_by_last_play", type, min_time, [&]() -> size_t {
+          auto &m = moves[index++ % moves.size()];
+          return Strategy::trim_by_last_play(m, last_play).size();
+        }));
+  }
+
+  printf("%-20s %-16s %12s %14s %12s\n", "function", "type", "ns/call",
+         "moves/sec", "allocs/call");
+  for (const auto &r : results) {
+    printf("%-20s %-16s %12.1f %14.0f %12.2f\n", r.name.c_str(),
+           type_name(r.type), r.ns_per_call(), r.moves_per_sec(),
+           r.allocations_per_call());
+  }
+  if (!json_path.empty()) {
+    write_json(json_path, seed, corpus_size, results);
+  }
+
+  // The masks of the whole corpus at once
+  HandBatch batch(corpus.size());
+  for (size_t i = 0; i < corpus.size(); i++) {
+    batch.set(i, corpus[i]);
+  }
+  printf("\n%-20s %12s\n", "HandBatch", "ns/hand");
+  for (bool simd : {false, true}) {
+    if (simd && !HandBatch::has_avx2()) {
+      continue;
+    }
+    Result r = measure("", TYPE_START, min_time, [&]() -> size_t {
+      simd ? batch.compute() : batch.compute_scalar();
+      return batch.size();
+    });
+    printf("%-20s %12.2f\n", simd ? "compute (avx2)" : "compute_scalar",
+           r.seconds * 1e9 / r.moves);
+  }
+
+  // Bidding in bulk: the masks, then the strength of every hand
+  vector<int16_t> strengths;
+  Result r = measure("", TYPE_START, min_time, [&]() -> size_t {
+    batch.compute();
+    Bidding::strength(batch, strengths);
+    return batch.size();
+  });
+  printf("%-20s %12.2f   (%.1fM deals/s)\n", "Bidding::strength",
+         r.seconds * 1e9 / r.moves, r.moves / r.seconds / 3e6);
+  return 0;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "Arena.h"
+#include "Protocol.h"
+#include "Random.h"
+#include "Strategy.h"
+
+using namespace std;
+using Protocol::Message;
+
+/**
+ * Loopback test client of the game server: every connection opens a number
+ * of tables at once and plays all their seats at random, then the turn
+ * latency (from an answer to the next request of the same table) is printed.
+ */
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+  string address = ":7777";
+  int connection_num = 1;
+  int table_num = 100;
+  int game_num = 1000;
+  uint64_t seed = 0;
+  bid_rule_t rule = RULE_ROB;
+};
+
+struct Result {
+  uint64_t games = 0;
+  uint64_t turns = 0;
+  uint64_t errors = 0;
+  // Microseconds
+  vector<float> latency;
+};
+
+// Plays game_num games on one connection, table_num of them at once
+void play(const Options &options, int id, Result &result) {
+  int fd = Protocol::connect_to(options.address);
+  Random rng(Random::mix(options.seed ^ (uint64_t)id << 32));
+  Arena arena;
+  vector<Clock::time_point> sent(options.table_num);
+  vector<char> in, out;
+  int started = 0;
+
+  auto open = [&](uint32_t table) {
+    Message m{Protocol::MSG_OPEN, table};
+    m.seed = Random::mix(options.seed ^ (uint64_t)id << 32 ^ started++);
+    m.rule = options.rule;
+    Protocol::encode(m, out);
+    sent[table] = Clock::now();
+  };
+  for (int t = 0; t < options.table_num && started < options.game_num; t++) {
+    open(t);
+  }
+
+  char chunk[64 * 1024];
+  while (result.games + result.errors < (uint64_t)options.game_num) {
+    if (!out.empty()) {
+      size_t done = 0;
+      while (done < out.size()) {
+        ssize_t n = send(fd, out.data() + done, out.size() - done, 0);
+        if (n <= 0) {
+          throw runtime_error("Connection lost");
+        }
+        done += n;
+      }
+      out.clear();
+    }
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+      throw runtime_error("Connection lost");
+    }
+    in.insert(in.end(), chunk, chunk + n);
+
+    size_t used = 0;
+    while (true) {
+      long size = Protocol::frame_size(in.data() + used, in.size() - used);
+      // A bad length never becomes a frame, waiting for more data would hang
+      if (size < 0) {
+        throw runtime_error("Bad frame from the server");
+      }
+      if (size == 0) {
+        break;
+      }
+      Message m;
+      if (!Protocol::decode(in.data() + used + 4, size - 4, m)) {
+        throw runtime_error("Bad message from the server");
+      }
+      used += size;
+      auto now = Clock::now();
+      result.latency.push_back(
+          chrono::duration<float, micro>(now - sent[m.table]).count());
+
+      Message answer{Protocol::MSG_BID, m.table};
+      switch (m.type) {
+      case Protocol::MSG_BID_REQUEST:
+        if (m.stage == BID_POINTS) {
+          int points = rng.bounded(4);
+          answer.answer = points > m.highest ? points : 0;
+        } else {
+          answer.answer = rng.bounded(2);
+        }
+        break;
+      case Protocol::MSG_MOVE_REQUEST: {
+        result.turns++;
+        arena.reset();
+        auto moves = Strategy::get_moves(Hand::from_cards(m.hand), m.move,
+                                         arena.get());
+        answer.type = Protocol::MSG_MOVE;
+        // Pass (the last index) only when not leading
+        int choice = rng.bounded(moves.size() + (m.last_player != -1));
+        answer.move = choice < (int)moves.size() ? moves[choice] : Move::none();
+        break;
+      }
+      case Protocol::MSG_GAME_OVER:
+      case Protocol::MSG_ERROR:
+        (m.type == Protocol::MSG_GAME_OVER ? result.games : result.errors)++;
+        if (started < options.game_num) {
+          open(m.table);
+        }
+        continue;
+      default:
+        throw runtime_error("Unexpected message from the server");
+      }
+      Protocol::encode(answer, out);
+      sent[m.table] = now;
+    }
+    in.erase(in.begin(), in.begin() + used);
+  }
+  close(fd);
+}
+
+void usage(const char *name) {
+  cerr << "Usage: " << name
+       << " [-a address] [-c connections] [-t tables per connection]"
+          " [-n games per connection] [-s seed] [-r rob|points]\n";
+  exit(1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 == argc) {
+      usage(argv[0]);
+    }
+    if (arg == "-a") {
+      options.address = argv[++i];
+    } else if (arg == "-c") {
+      options.connection_num = stoi(argv[++i]);
+    } else if (arg == "-t") {
+      options.table_num = stoi(argv[++i]);
+    } else if (arg == "-n") {
+      options.game_num = stoi(argv[++i]);
+    } else if (arg == "-s") {
+      options.seed = stoull(argv[++i]);
+    } else if (arg == "-r") {
+      string rule = argv[++i];
+      if (rule != "rob" && rule != "points") {
+        usage(argv[0]);
+      }
+      options.rule = rule == "points" ? RULE_POINTS : RULE_ROB;
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (options.connection_num < 1 || options.table_num < 1) {
+    usage(argv[0]);
+  }
+
+  vector<Result> results(options.connection_num);
+  vector<thread> threads;
+  auto start = Clock::now();
+  for (int i = 0; i < options.connection_num; i++) {
+    threads.emplace_back(play, cref(options), i, ref(results[i]));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+  Result total;
+  for (auto &r : results) {
+    total.games += r.games;
+    total.turns += r.turns;
+    total.errors += r.errors;
+    total.latency.insert(total.latency.end(), r.latency.begin(),
+                         r.latency.end());
+  }
+  sort(total.latency.begin(), total.latency.end());
+  auto percentile = [&](double p) {
+    return total.latency.empty()
+               ? 0.0f
+               : total.latency[(size_t)(p * (total.latency.size() - 1))];
+  };
+
+  cout << "Games:        " << total.games << '\n';
+  cout << "Errors:       " << total.errors << '\n';
+  cout << "Seconds:      " << seconds << '\n';
+  cout << "Games/sec:    " << total.games / seconds << '\n';
+  cout << "Turns/sec:    " << total.turns / seconds << '\n';
+  cout << "Latency (us): p50 " << percentile(0.5) << ", p99 "
+       << percentile(0.99) << ", max " << percentile(1) << endl;
+  return 0;
+}
@@ -1,11 +1,38 @@
 #include <iostream>
+#include <string>
+#include <thread>
 #include "Game.h"
+#include "MctsAgent.h"
 
 using namespace std;
 
-int main() {
-  Game game;
+/**
+ * Usage: main [--bots | --ai]
+ *   --bots  all three players are random bots, nothing is printed
+ *   --ai    player 0 is typed on the console, players 1 and 2 are MCTS bots
+ *           with 1 second per move
+ */
+int main(int argc, char *argv[]) {
+  bool bots = argc > 1 && string(argv[1]) == "--bots";
+  bool ai = argc > 1 && string(argv[1]) == "--ai";
+
+  ConsoleAgent console;
+  RandomAgent random_agents[3] = {RandomAgent(0), RandomAgent(1),
+                                  RandomAgent(2)};
+  int thread_num = (int)max(1u, thread::hardware_concurrency());
+  MctsAgent mcts_agent(thread_random()(), {0, 1000}, thread_num);
+  array<Agent *, 3> agents = {&console, &console, &console};
+  if (bots) {
+    agents = {&random_agents[0], &random_agents[1], &random_agents[2]};
+  } else if (ai) {
+    agents = {&console, &mcts_agent, &mcts_agent};
+  }
+
+  Game game(agents, bots);
   game.init();
-  game.run();
+  int winner = game.run();
+  if (bots) {
+    cout << "Player " << winner << " wins the game!" << endl;
+  }
   return 0;
 }
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameRecord.h"
+#include "Replay.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+namespace {
+
+// Failures printed one by one, the others are only counted
+constexpr size_t MAX_PRINTED = 20;
+
+// Results of the games checked by one thread
+struct alignas(64) ReplayStats {
+  uint64_t games = 0;
+  uint64_t statuses[Replay::STATUS_END] = {};
+  // Index of the game and what went wrong, rare
+  vector<pair<size_t, Replay::Result>> failures;
+};
+
+void usage(const char *name) {
+  cerr << "Usage: " << name
+       << " [-t threads] [-g grain] [-a] [-p game] records...\n"
+          "  -a       also check every position with the CardSet functions\n"
+          "  -p game  replay and print this game of the first file only\n";
+  exit(1);
+}
+
+// Print one game as it is replayed
+int print_game(const string &path, size_t game, bool audit) {
+  RecordReader reader(path);
+  size_t index = 0;
+  for (auto view : reader) {
+    if (index++ != game) {
+      continue;
+    }
+    GameRecord record = view.to_record();
+    cout << "Seed " << record.seed << '\n';
+    Replay::Result result = Replay::verify(record, audit, &cout);
+    cout << Replay::to_string(result.status);
+    if (result.index >= 0) {
+      cout << " at " << result.index;
+    }
+    cout << endl;
+    return result.status == Replay::OK ? 0 : 1;
+  }
+  cerr << path << " has no game " << game << '\n';
+  return 1;
+}
+
+} // namespace
+
+/**
+ * Check every game of the record files written by selfplay -o: same deal,
+ * legal bids and moves, same winner (see Replay.h). Nothing is printed per
+ * game but the failures, so that millions of games go by in a minute.
+ */
+int main(int argc, char *argv[]) {
+  int thread_num = (int)max(1u, thread::hardware_concurrency());
+  size_t grain = 256;
+  bool audit = false;
+  long long print = -1;
+  vector<string> paths;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (arg == "-a") {
+      audit = true;
+    } else if (arg[0] == '-' && i + 1 == argc) {
+      usage(argv[0]);
+    } else if (arg == "-t") {
+      thread_num = stoi(argv[++i]);
+    } else if (arg == "-g") {
+      grain = stoull(argv[++i]);
+    } else if (arg == "-p") {
+      print = stoll(argv[++i]);
+    } else if (arg[0] == '-') {
+      usage(argv[0]);
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty() || thread_num < 1 || grain < 1) {
+    usage(argv[0]);
+  }
+  // A file that can not be read, or a truncated or corrupt one, is reported
+  // as a failure like a bad game
+  if (print >= 0) {
+    try {
+      return print_game(paths[0], print, audit);
+    } catch (const runtime_error &e) {
+      cerr << paths[0] << ": " << e.what() << '\n';
+      return 1;
+    }
+  }
+
+  // Every record of every file, and the index of the first one of each file
+  vector<unique_ptr<RecordReader>> readers;
+  vector<RecordReader::RecordView> views;
+  vector<size_t> file_start;
+  for (const auto &path : paths) {
+    try {
+      readers.push_back(make_unique<RecordReader>(path));
+      file_start.push_back(views.size());
+      for (auto view : *readers.back()) {
+        views.push_back(view);
+      }
+    } catch (const runtime_error &e) {
+      cerr << path << ": " << e.what() << '\n';
+      return 1;
+    }
+  }
+
+  WorkStealingPool pool(thread_num);
+  vector<ReplayStats> stats(thread_num);
+  vector<GameRecord> records(thread_num);
+
+  auto start = chrono::steady_clock::now();
+  pool.parallel_for(views.size(), grain, [&](int id, size_t index) {
+    GameRecord &record = records[id];
+    views[index].to_record(record);
+    Replay::Result result = Replay::verify(record, audit);
+    ReplayStats &s = stats[id];
+    s.games++;
+    s.statuses[result.status]++;
+    if (result.status != Replay::OK) {
+      s.failures.push_back({index, result});
+    }
+  });
+  auto end = chrono::steady_clock::now();
+
+  ReplayStats total;
+  for (auto &s : stats) {
+    total.games += s.games;
+    for (int i = 0; i < Replay::STATUS_END; i++) {
+      total.statuses[i] += s.statuses[i];
+    }
+    total.failures.insert(total.failures.end(), s.failures.begin(),
+                          s.failures.end());
+  }
+  sort(total.failures.begin(), total.failures.end(),
+       [](const auto &f1, const auto &f2) { return f1.first < f2.first; });
+  for (size_t i = 0; i < min(total.failures.size(), MAX_PRINTED); i++) {
+    auto [index, result] = total.failures[i];
+    size_t file =
+        upper_bound(file_start.begin(), file_start.end(), index) -
+        file_start.begin() - 1;
+    cout << paths[file] << " game " << index - file_start[file] << " (seed "
+         << views[index].seed() << "): " << Replay::to_string(result.status);
+    if (result.index >= 0) {
+      cout << " at " << result.index;
+    }
+    cout << '\n';
+  }
+  double seconds = chrono::duration<double>(end - start).count();
+
+  cout << "Games:         " << total.games << '\n';
+  cout << "Threads:       " << thread_num << '\n';
+  cout << "Seconds:       " << seconds << '\n';
+  cout << "Games/sec:     " << total.games / seconds << '\n';
+  for (int i = 0; i < Replay::STATUS_END; i++) {
+    if (total.statuses[i] > 0) {
+      cout << Replay::to_string((Replay::status_t)i) << ": "
+           << total.statuses[i] << '\n';
+    }
+  }
+  cout << flush;
+  return total.failures.empty() ? 0 : 1;
+}
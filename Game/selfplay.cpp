@@ -0,0 +1,173 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Game.h"
+#include "GameRecord.h"
+#include "Profile.h"
+#include "Random.h"
+#include "TrainingData.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+namespace {
+
+// Results of the games played by one thread
+struct alignas(64) SelfPlayStats {
+  uint64_t games = 0;
+  uint64_t landlord_wins = 0;
+  uint64_t rounds = 0;
+  uint64_t wins[3] = {0, 0, 0};
+
+  SelfPlayStats &operator+=(const SelfPlayStats &s) {
+    games += s.games;
+    landlord_wins += s.landlord_wins;
+    rounds += s.rounds;
+    for (int i = 0; i < 3; i++) {
+      wins[i] += s.wins[i];
+    }
+    return *this;
+  }
+};
+
+// Everything a thread needs to play games on its own
+struct Player {
+  RandomAgent agents[3];
+  Game game;
+
+  explicit Player(bid_rule_t rule)
+      : agents{RandomAgent(0), RandomAgent(1), RandomAgent(2)},
+        game({&agents[0], &agents[1], &agents[2]}, true, 0, rule) {}
+
+  // The game only depends on the seed, not on the thread playing it
+  int play(uint64_t seed) {
+    for (int i = 0; i < 3; i++) {
+      agents[i].seed(Random::mix(seed + i + 1));
+    }
+    game.init(seed);
+    return game.run();
+  }
+};
+
+void usage(const char *name) {
+  cerr << "Usage: " << name
+       << " [-n games] [-t threads] [-g grain] [-s seed] [-o records]"
+          " [-r rob|points] [-d training prefix]\n";
+  exit(1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t game_num = 100000;
+  int thread_num = (int)max(1u, thread::hardware_concurrency());
+  size_t grain = 64;
+  uint64_t seed = 0;
+  // Write every game to this file if not empty, see GameRecord.h
+  string record_path;
+  // Write training samples to shards of this prefix if not empty, see
+  // TrainingData.h
+  string training_prefix;
+  bid_rule_t rule = RULE_ROB;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 == argc) {
+      usage(argv[0]);
+    }
+    if (arg == "-n") {
+      game_num = stoull(argv[++i]);
+    } else if (arg == "-t") {
+      thread_num = stoi(argv[++i]);
+    } else if (arg == "-g") {
+      grain = stoull(argv[++i]);
+    } else if (arg == "-s") {
+      seed = stoull(argv[++i]);
+    } else if (arg == "-o") {
+      record_path = argv[++i];
+    } else if (arg == "-d") {
+      training_prefix = argv[++i];
+    } else if (arg == "-r") {
+      string name = argv[++i];
+      if (name != "rob" && name != "points") {
+        usage(argv[0]);
+      }
+      rule = name == "points" ? RULE_POINTS : RULE_ROB;
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (game_num < 1 || thread_num < 1 || grain < 1) {
+    usage(argv[0]);
+  }
+
+  unique_ptr<RecordWriter> writer;
+  if (!record_path.empty()) {
+    writer = make_unique<RecordWriter>(record_path);
+  }
+  unique_ptr<TrainingWriter> training;
+  if (!training_prefix.empty()) {
+    training = make_unique<TrainingWriter>(training_prefix);
+  }
+
+  WorkStealingPool pool(thread_num);
+  vector<unique_ptr<Player>> players(thread_num);
+  vector<SelfPlayStats> stats(thread_num);
+
+  auto start = chrono::steady_clock::now();
+  pool.parallel_for(game_num, grain, [&](int id, size_t index) {
+    if (!players[id]) {
+      players[id] = make_unique<Player>(rule);
+    }
+    Game &game = players[id]->game;
+    int winner = players[id]->play(Random::mix(seed ^ index));
+    if (writer) {
+      writer->write(game.get_record());
+    }
+    if (training) {
+      training->write(game.get_record());
+    }
+
+    SelfPlayStats &s = stats[id];
+    s.games++;
+    s.rounds += game.get_round();
+    s.wins[winner]++;
+    // Both peasants win if either of them runs out of cards
+    if (winner == game.get_landlord()) {
+      s.landlord_wins++;
+    }
+  });
+  if (writer) {
+    writer->close();
+  }
+  if (training) {
+    training->close();
+  }
+  auto end = chrono::steady_clock::now();
+
+  SelfPlayStats total;
+  for (const auto &s : stats) {
+    total += s;
+  }
+  double seconds = chrono::duration<double>(end - start).count();
+
+  cout << "Games:         " << total.games << '\n';
+  cout << "Threads:       " << thread_num << '\n';
+  cout << "Seconds:       " << seconds << '\n';
+  cout << "Games/sec:     " << total.games / seconds << '\n';
+  cout << "Landlord wins: " << (double)total.landlord_wins / total.games
+       << '\n';
+  cout << "Rounds/game:   " << (double)total.rounds / total.games << '\n';
+  cout << "Wins by seat:  " << total.wins[0] << " " << total.wins[1] << " "
+       << total.wins[2] << endl;
+  if (training) {
+    cout << "Samples:       " << training->get_samples() << '\n';
+    cout << "Training MB/s: " << training->get_bytes() / seconds / 1e6 << '\n';
+    cout << "Shards:        " << training->get_shard_num() << '\n';
+    cout << "Export stalls: " << training->get_stalls() << endl;
+  }
+  Profile::dump(cout);
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "Profile.h"
+#include "Server.h"
+
+using namespace std;
+
+namespace {
+
+Server *running = nullptr;
+
+void on_signal(int) {
+  if (running) {
+    running->stop();
+  }
+}
+
+void usage(const char *name) {
+  cerr << "Usage: " << name << " [-a address] [-t threads]\n"
+       << "  address: host:port, :port or unix:/path (default :7777)\n";
+  exit(1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  string address = ":7777";
+  int thread_num = (int)max(1u, thread::hardware_concurrency());
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 == argc) {
+      usage(argv[0]);
+    }
+    if (arg == "-a") {
+      address = argv[++i];
+    } else if (arg == "-t") {
+      thread_num = stoi(argv[++i]);
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (thread_num < 1) {
+    usage(argv[0]);
+  }
+
+  Server server(address, thread_num);
+  running = &server;
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  cout << "Serving on " << address << " with " << thread_num << " threads"
+       << endl;
+  server.run();
+  cout << "Games: " << server.get_games() << endl;
+  Profile::dump(cout);
+  return 0;
+}
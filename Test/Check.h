@@ -0,0 +1,27 @@
+#ifndef TEST_CHECK
+#define TEST_CHECK
+
+#include <iostream>
+
+/**
+ * @brief Minimal checks for the test executables: a failed CHECK prints where
+ * it failed and the test goes on, main returns CHECK_RESULT() so that ctest
+ * sees the failure.
+ */
+inline int &check_failures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed"  \
+                << std::endl;                                                  \
+      check_failures()++;                                                      \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_RESULT() (check_failures() == 0 ? 0 : 1)
+
+#endif // TEST_CHECK
@@ -0,0 +1,77 @@
+#include "Check.h"
+
+#include <bit>
+#include <iostream>
+
+#include "HandBatch.h"
+#include "Random.h"
+
+namespace {
+
+Hand random_hand(Random &rng, int n) {
+  uint64_t cards = 0;
+  while (std::popcount(cards) < n) {
+    cards |= 1ULL << rng.bounded(54);
+  }
+  return Hand::from_cards(cards);
+}
+
+// compute() takes the AVX2 path when the CPU has it, and must give what
+// compute_scalar gives for every hand, also in the tails shorter than a
+// vector (2 hands for the counts, 16 for the sequences)
+void test_avx2_matches_scalar() {
+  if (!HandBatch::has_avx2()) {
+    std::cout << "no AVX2, compute() is compute_scalar()" << std::endl;
+  }
+  Random rng(1);
+  const size_t SIZES[] = {0, 1, 2, 3, 15, 16, 17, 31, 32, 33, 47, 100, 1000};
+  for (size_t size : SIZES) {
+    for (int round = 0; round < 20; round++) {
+      HandBatch simd(size), scalar(size);
+      for (size_t i = 0; i < size; i++) {
+        // Up to the whole deck, for the long sequences and the bombs
+        Hand hand = random_hand(rng, rng.bounded(55));
+        simd.set(i, hand);
+        scalar.set(i, hand);
+      }
+      simd.compute();
+      scalar.compute_scalar();
+      for (size_t i = 0; i < size; i++) {
+        for (int n = 1; n <= 4; n++) {
+          CHECK(simd.at_least(i, n) == scalar.at_least(i, n));
+        }
+        for (int m = 1; m <= 3; m++) {
+          CHECK(simd.sequence(i, m) == scalar.sequence(i, m));
+        }
+        CHECK(simd.rocket(i) == scalar.rocket(i));
+      }
+    }
+  }
+}
+
+// The scalar path itself, against Hand
+void test_scalar() {
+  Random rng(2);
+  HandBatch batch(200);
+  Hand hands[200];
+  for (size_t i = 0; i < batch.size(); i++) {
+    hands[i] = random_hand(rng, rng.bounded(55));
+    batch.set(i, hands[i]);
+  }
+  batch.compute_scalar();
+  for (size_t i = 0; i < batch.size(); i++) {
+    for (int n = 1; n <= 4; n++) {
+      CHECK(batch.at_least(i, n) == hands[i].ranks_with_at_least(n));
+    }
+    CHECK(batch.rocket(i) == (hands[i].count(Hand::RANK_BLACK_JOKER) &&
+                              hands[i].count(Hand::RANK_RED_JOKER)));
+  }
+}
+
+} // namespace
+
+int main() {
+  test_avx2_matches_scalar();
+  test_scalar();
+  return CHECK_RESULT();
+}
@@ -0,0 +1,283 @@
+#include "Check.h"
+
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <vector>
+
+#include "Hand.h"
+#include "Move.h"
+#include "Random.h"
+#include "Sequence.h"
+#include "Strategy.h"
+
+namespace {
+
+// Ranks in the order of Card::get_rank, B and R for the jokers
+const std::string RANK_CHARS = "3456789TJQKA2BR";
+
+// The longest airplanes of a hand of 20 cards, by cards per wing
+const int MAX_AIRPLANE_LENGTH[3] = {0, 5, 4};
+
+Hand from_ranks(const std::string &ranks) {
+  uint64_t cards = 0;
+  for (char c : ranks) {
+    int r = RANK_CHARS.find(c);
+    for (int id = 0; id < 54; id++) {
+      if (!(cards >> id & 1) && Card(id).get_rank() == r) {
+        cards |= 1ULL << id;
+        break;
+      }
+    }
+  }
+  return Hand::from_cards(cards);
+}
+
+Hand random_hand(Random &rng, int n) {
+  uint64_t cards = 0;
+  while (std::popcount(cards) < n) {
+    cards |= 1ULL << rng.bounded(54);
+  }
+  return Hand::from_cards(cards);
+}
+
+/**
+ * @brief Every move of at most 20 cards, built from the rules of the types
+ * over all ranks, without looking at a hand
+ */
+std::vector<Move> all_moves() {
+  std::vector<Move> moves;
+  auto add = [&](const Move &m) {
+    if (m.size() <= 20) {
+      moves.push_back(m);
+    }
+  };
+  for (int r = 0; r < Hand::RANK_NUM; r++) {
+    add(Move(Single, r));
+  }
+  for (int r = 0; r < Hand::RANK_BLACK_JOKER; r++) {
+    add(Move(Double, r));
+    add(Move(Triple, r));
+    add(Move(Bomb, r));
+  }
+  add(Move::rocket());
+
+  const type_t SEQUENCES[4] = {TYPE_START, SingleSeq, DoubleSeq, ThreeSeq};
+  for (int m = 1; m <= 3; m++) {
+    for (int l = Sequence::MIN_LENGTH[m]; l <= Sequence::MAX_LENGTH; l++) {
+      for (int s = 0; s + l <= Sequence::MAX_RANK; s++) {
+        add(Move(SEQUENCES[m], s, l));
+      }
+    }
+  }
+
+  // Kickers of other ranks than the base, the jokers only as single cards
+  for (int r = 0; r < Hand::RANK_BLACK_JOKER; r++) {
+    for (int k = 0; k < Hand::RANK_NUM; k++) {
+      if (k == r) {
+        continue;
+      }
+      add(Move(ThreeOne, r, 1, 1 << k));
+      if (k < Hand::RANK_BLACK_JOKER) {
+        add(Move(ThreeTwo, r, 1, 1 << k));
+      }
+      for (int k2 = k + 1; k2 < Hand::RANK_NUM; k2++) {
+        if (k2 == r) {
+          continue;
+        }
+        add(Move(Four_Two_Single, r, 1, 1 << k | 1 << k2));
+        if (k2 < Hand::RANK_BLACK_JOKER) {
+          add(Move(Four_Two_Pair, r, 1, 1 << k | 1 << k2));
+        }
+      }
+    }
+  }
+
+  // Airplanes: a wing of a pair for every triple, or of a card for every
+  // triple with at most two cards of one rank
+  for (int l = 2; 4 * l <= 20; l++) {
+    for (int s = 0; s + l <= Sequence::MAX_RANK; s++) {
+      uint32_t base = ((1 << l) - 1) << s;
+      for (uint32_t k = 0; k < 1 << Hand::RANK_NUM; k++) {
+        int n = std::popcount(k);
+        if ((k & base) || n > l) {
+          continue;
+        }
+        if (n == l && k < 1 << Hand::RANK_BLACK_JOKER) {
+          add(Move(Airplane_Pair, s, l, k));
+        }
+        // l - n of the kicker ranks give two cards, not a joker (the
+        // highest kickers)
+        int jokers = std::popcount(k >> Hand::RANK_BLACK_JOKER);
+        for (uint32_t p = 0; p < 1U << (n - jokers); p++) {
+          if (std::popcount(p) == l - n) {
+            add(Move(Airplane_Single, s, l, k, p));
+          }
+        }
+      }
+    }
+  }
+  return moves;
+}
+
+const std::vector<Move> &universe() {
+  static const std::vector<Move> moves = all_moves();
+  return moves;
+}
+
+// Every count of the move is at most the count of the hand: no counter of
+// (hand + 8) - move borrows, as counts are at most 4
+bool fits(uint64_t move, uint64_t hand) {
+  constexpr uint64_t HIGH = Hand::NIBBLE_LOW * 8;
+  return (((hand | HIGH) - move) & HIGH) == HIGH;
+}
+
+std::vector<uint32_t> sorted_codes(std::vector<uint32_t> codes) {
+  std::sort(codes.begin(), codes.end());
+  return codes;
+}
+
+// The moves of hand that beat last, by brute force over the universe
+std::vector<uint32_t> expected(const Hand &hand, const Move &last) {
+  std::vector<uint32_t> codes;
+  for (const auto &m : universe()) {
+    if (fits(m.counts(), hand.get_counts()) && m.beats(last)) {
+      codes.push_back(m.encode());
+    }
+  }
+  return sorted_codes(codes);
+}
+
+// All the ways to generate the moves agree with the brute force
+void check_moves(const Hand &hand, const Move &last) {
+  static const Hand DECK = Hand::from_cards((1ULL << 54) - 1);
+  std::vector<uint32_t> want = expected(hand, last);
+
+  std::vector<uint32_t> generated;
+  for (const auto &m : Strategy::generate(hand, last)) {
+    generated.push_back(m.encode());
+  }
+  std::vector<uint32_t> listed;
+  for (const auto &m : Strategy::get_moves(hand, last)) {
+    listed.push_back(m.encode());
+  }
+  // The same moves in the same order
+  CHECK(listed == generated);
+  generated = sorted_codes(generated);
+  CHECK(std::adjacent_find(generated.begin(), generated.end()) ==
+        generated.end());
+  CHECK(generated == want);
+
+  CardSet last_set = last.to_card_set(DECK);
+  std::vector<uint32_t> beating;
+  for (const auto &c : Strategy::get_possible_move(hand, last_set)) {
+    beating.push_back(Move::from_card_set(c).encode());
+  }
+  CHECK(sorted_codes(beating) == want);
+
+  Type type = last.is_none() ? Type(TYPE_START) : last.get_type();
+  std::vector<CardSet> possible = Strategy::get_possible_move(hand, type);
+  std::vector<uint32_t> trimmed;
+  for (const auto &c : Strategy::trim_by_last_play(possible, last_set)) {
+    trimmed.push_back(Move::from_card_set(c).encode());
+  }
+  CHECK(sorted_codes(trimmed) == want);
+}
+
+// A random move of the universe, of a type chosen uniformly first
+Move random_move(Random &rng) {
+  static const std::vector<std::vector<Move>> by_type = []() {
+    std::vector<std::vector<Move>> moves(TYPE_END);
+    for (const auto &m : universe()) {
+      moves[m.type].push_back(m);
+    }
+    return moves;
+  }();
+  const std::vector<Move> *moves;
+  do {
+    moves = &by_type[rng.bounded(TYPE_END)];
+  } while (moves->empty());
+  return (*moves)[rng.bounded(moves->size())];
+}
+
+void test_leads() {
+  Random rng(1);
+  for (int i = 0; i < 500; i++) {
+    check_moves(random_hand(rng, 1 + rng.bounded(20)), Move::none());
+  }
+}
+
+void test_follow_ups() {
+  Random rng(2);
+  for (int i = 0; i < 500; i++) {
+    Hand hand = random_hand(rng, 1 + rng.bounded(20));
+    for (int j = 0; j < 5; j++) {
+      check_moves(hand, random_move(rng));
+    }
+  }
+}
+
+// An airplane of length l from s, with its wings on the lowest other ranks
+Move airplane(type_t type, int s, int l) {
+  uint16_t kickers = 0;
+  for (int k = 0; std::popcount(kickers) < l; k++) {
+    if (k < s || k >= s + l) {
+      kickers |= 1 << k;
+    }
+  }
+  return Move(type, s, l, kickers);
+}
+
+// Hands built around an airplane, up to the longest ones
+void test_airplanes() {
+  CHECK(airplane(Airplane_Single, 0, MAX_AIRPLANE_LENGTH[1]).size() == 20);
+  CHECK(airplane(Airplane_Pair, 0, MAX_AIRPLANE_LENGTH[2]).size() == 20);
+  const std::string HANDS[] = {
+      "333444555666777" "89TJQ", "333444555666777" "889TT",
+      "333444555666777" "BR2A2", "333444555666" "7788TTJJ",
+      "TTTJJJQQQKKK" "AA223344", "JJJQQQKKKAAA" "22334455",
+  };
+  for (const auto &ranks : HANDS) {
+    Hand hand = from_ranks(ranks);
+    check_moves(hand, Move::none());
+    for (int wing = 1; wing <= 2; wing++) {
+      type_t type = wing == 1 ? Airplane_Single : Airplane_Pair;
+      for (int l = 2; l <= MAX_AIRPLANE_LENGTH[wing]; l++) {
+        for (int s = 0; s + l <= Sequence::MAX_RANK; s++) {
+          check_moves(hand, airplane(type, s, l));
+        }
+      }
+    }
+  }
+
+  // Random hands holding an airplane of random length
+  Random rng(3);
+  for (int i = 0; i < 300; i++) {
+    int wing = 1 + rng.bounded(2);
+    int l = 2 + rng.bounded(MAX_AIRPLANE_LENGTH[wing] - 1);
+    int s = rng.bounded(Sequence::MAX_RANK - l + 1);
+    std::string ranks;
+    for (int r = s; r < s + l; r++) {
+      ranks += std::string(3, RANK_CHARS[r]);
+    }
+    Hand hand = from_ranks(ranks);
+    int size = 3 * l + rng.bounded(20 - 3 * l + 1);
+    while (hand.size() < size) {
+      Card c(rng.bounded(54));
+      if (!hand.contains(c)) {
+        hand.add(c);
+      }
+    }
+    check_moves(hand, Move::none());
+    check_moves(hand, random_move(rng));
+  }
+}
+
+} // namespace
+
+int main() {
+  test_leads();
+  test_follow_ups();
+  test_airplanes();
+  return CHECK_RESULT();
+}
@@ -0,0 +1,151 @@
+#include "Check.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "Protocol.h"
+#include "Server.h"
+
+using Protocol::Message;
+
+namespace {
+
+// The payload of the only frame of out
+bool decode_frame(const std::vector<char> &out, Message &message) {
+  long size = Protocol::frame_size(out.data(), out.size());
+  CHECK(size == (long)out.size());
+  return Protocol::decode(out.data() + 4, out.size() - 4, message);
+}
+
+void test_round_trip() {
+  Message open{Protocol::MSG_OPEN, 7};
+  open.seed = 0x123456789ABCDEFULL;
+  open.rule = RULE_POINTS;
+  std::vector<char> out;
+  Protocol::encode(open, out);
+  Message m;
+  CHECK(decode_frame(out, m));
+  CHECK(m.type == Protocol::MSG_OPEN && m.table == 7);
+  CHECK(m.seed == open.seed && m.rule == RULE_POINTS);
+
+  Message request{Protocol::MSG_MOVE_REQUEST, 3};
+  request.player = 2;
+  request.landlord = 1;
+  request.last_player = -1;
+  request.move = Move(Triple, 4);
+  request.hand = 0x3FFFF;
+  request.hand_size[0] = 17;
+  request.hand_size[1] = 20;
+  request.hand_size[2] = 16;
+  out.clear();
+  Protocol::encode(request, out);
+  CHECK(decode_frame(out, m));
+  CHECK(m.type == Protocol::MSG_MOVE_REQUEST && m.table == 3);
+  CHECK(m.player == 2 && m.landlord == 1 && m.last_player == -1);
+  CHECK(m.move == Move(Triple, 4) && m.hand == 0x3FFFF);
+  CHECK(m.hand_size[1] == 20);
+}
+
+void test_rejects() {
+  Message open{Protocol::MSG_OPEN, 1};
+  std::vector<char> out;
+  Protocol::encode(open, out);
+  Message m;
+  // The rule is the last byte
+  out.back() = 2;
+  CHECK(!decode_frame(out, m));
+  out.back() = (char)0xFF;
+  CHECK(!decode_frame(out, m));
+
+  for (int type : {0, Protocol::MSG_ERROR + 1, 0xFF}) {
+    out.clear();
+    Protocol::encode(Message{Protocol::MSG_ERROR, 1}, out);
+    out[4] = (char)type;
+    CHECK(!decode_frame(out, m));
+  }
+
+  // Too short, then too long for the type
+  out.clear();
+  Protocol::encode(Message{Protocol::MSG_BID, 1}, out);
+  CHECK(!Protocol::decode(out.data() + 4, out.size() - 5, m));
+  out.push_back(0);
+  CHECK(!Protocol::decode(out.data() + 4, out.size() - 4, m));
+
+  // Frames larger than any message
+  std::vector<char> big(4 + Protocol::MAX_PAYLOAD + 1);
+  big[0] = (char)(Protocol::MAX_PAYLOAD + 1);
+  CHECK(Protocol::frame_size(big.data(), big.size()) == -1);
+  CHECK(Protocol::frame_size(big.data(), 3) == 0);
+}
+
+// Send out, then read a whole frame into message
+bool exchange(int fd, const std::vector<char> &out, Message &message) {
+  if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+    return false;
+  }
+  std::vector<char> in;
+  char chunk[256];
+  long size;
+  while ((size = Protocol::frame_size(in.data(), in.size())) == 0) {
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+      return false;
+    }
+    in.insert(in.end(), chunk, chunk + n);
+  }
+  return size > 0 && Protocol::decode(in.data() + 4, size - 4, message);
+}
+
+void test_server() {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "protocol_test.sock").string();
+  Server server("unix:" + path, 1);
+  std::thread thread([&]() { server.run(); });
+
+  // A bad rule is answered with MSG_ERROR, the connection stays open
+  int fd = Protocol::connect_to("unix:" + path);
+  std::vector<char> out;
+  Protocol::encode(Message{Protocol::MSG_OPEN, 5}, out);
+  out.back() = 7;
+  Message m;
+  CHECK(exchange(fd, out, m));
+  CHECK(m.type == Protocol::MSG_ERROR && m.table == 5);
+  out.clear();
+  Protocol::encode(Message{Protocol::MSG_OPEN, 6}, out);
+  CHECK(exchange(fd, out, m));
+  CHECK(m.type == Protocol::MSG_BID_REQUEST && m.table == 6);
+  close(fd);
+
+  // A client that never reads is dropped once the server holds too much
+  // for it, so its sends fail long before 64 MB of requests are sent
+  fd = Protocol::connect_to("unix:" + path);
+  out.clear();
+  for (int i = 0; i < 1000; i++) {
+    Protocol::encode(Message{Protocol::MSG_OPEN, (uint32_t)i}, out);
+  }
+  bool dropped = false;
+  for (size_t sent = 0; sent < (64 << 20) && !dropped; sent += out.size()) {
+    dropped = send(fd, out.data(), out.size(), MSG_NOSIGNAL) < 0 &&
+              (errno == EPIPE || errno == ECONNRESET);
+  }
+  CHECK(dropped);
+  close(fd);
+
+  server.stop();
+  thread.join();
+  std::filesystem::remove(path);
+}
+
+} // namespace
+
+int main() {
+  test_round_trip();
+  test_rejects();
+  test_server();
+  return CHECK_RESULT();
+}
@@ -0,0 +1,165 @@
+#include "Check.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "GameRecord.h"
+
+namespace {
+
+const std::string PATH =
+    (std::filesystem::temp_directory_path() / "record_reader_test.ddzr")
+        .string();
+
+GameRecord make_record(int i) {
+  GameRecord record;
+  record.seed = 1000 + i;
+  record.hands[0] = 0x7;
+  record.hands[1] = 0x38;
+  record.hands[2] = 0x1C0;
+  record.landlord_cards = 0xE00;
+  record.first_bidder = i % 3;
+  record.landlord = (i + 1) % 3;
+  record.winner = (i + 2) % 3;
+  // Different counts, so that the records have different sizes
+  for (int b = 0; b <= i; b++) {
+    record.bids.push_back(b % 2);
+  }
+  record.moves.push_back(Move(Single, i % 13));
+  for (int m = 0; m < i; m++) {
+    record.moves.push_back(Move::none());
+  }
+  record.moves.push_back(Move(SingleSeq, 0, 5));
+  return record;
+}
+
+void write_records(int n) {
+  RecordWriter writer(PATH);
+  for (int i = 0; i < n; i++) {
+    writer.write(make_record(i));
+  }
+}
+
+std::vector<char> read_file() {
+  std::ifstream in(PATH, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in), {});
+}
+
+void write_file(const std::vector<char> &bytes) {
+  std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+  out.write(bytes.data(), bytes.size());
+}
+
+// Walk every record, true if the reader threw std::runtime_error
+bool walk_throws() {
+  try {
+    RecordReader reader(PATH);
+    for (auto view : reader) {
+      (void)view.seed();
+    }
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+
+void test_round_trip() {
+  write_records(5);
+  RecordReader reader(PATH);
+  int i = 0;
+  for (auto view : reader) {
+    GameRecord expected = make_record(i);
+    GameRecord record = view.to_record();
+    CHECK(view.size() == RecordFormat::record_size(expected.bids.size(),
+                                                   expected.moves.size()));
+    CHECK(record.seed == expected.seed);
+    CHECK(record.landlord == expected.landlord);
+    CHECK(record.winner == expected.winner);
+    CHECK(record.bids == expected.bids);
+    CHECK(record.moves == expected.moves);
+    i++;
+  }
+  CHECK(i == 5);
+}
+
+void test_truncated() {
+  write_records(5);
+  std::vector<char> bytes = read_file();
+  // Cut inside the header of the first record, then inside the last one
+  for (size_t cut : {(size_t)12, (size_t)20, bytes.size() - 4}) {
+    std::vector<char> truncated(bytes.begin(), bytes.begin() + cut);
+    write_file(truncated);
+    CHECK(walk_throws());
+  }
+}
+
+void test_bad_size() {
+  write_records(3);
+  std::vector<char> bytes = read_file();
+  size_t first = RecordFormat::FILE_HEADER_SIZE;
+  uint32_t size;
+  std::memcpy(&size, bytes.data() + first, 4);
+  // 0 would loop forever, a huge one reads past the end, the others do not
+  // match the counts
+  for (uint32_t bad : {0u, 8u, size + 8, size - 8, 0xFFFFFFF0u}) {
+    std::vector<char> corrupt = bytes;
+    std::memcpy(corrupt.data() + first, &bad, 4);
+    write_file(corrupt);
+    CHECK(walk_throws());
+  }
+  // The counts no longer match the size
+  std::vector<char> corrupt = bytes;
+  uint16_t move_num = 1000;
+  std::memcpy(corrupt.data() + first + 6, &move_num, 2);
+  write_file(corrupt);
+  CHECK(walk_throws());
+}
+
+void test_bad_header() {
+  write_records(1);
+  std::vector<char> bytes = read_file();
+  std::vector<char> corrupt = bytes;
+  corrupt[0] = 'X';
+  write_file(corrupt);
+  CHECK(walk_throws());
+  corrupt = bytes;
+  uint32_t version = RecordFormat::VERSION + 1;
+  std::memcpy(corrupt.data() + 4, &version, 4);
+  write_file(corrupt);
+  CHECK(walk_throws());
+}
+
+// Every write to /dev/full fails, which close() must report
+void test_write_error() {
+  if (!std::filesystem::exists("/dev/full")) {
+    return;
+  }
+  RecordWriter writer("/dev/full", 64);
+  for (int i = 0; i < 10; i++) {
+    writer.write(make_record(i));
+  }
+  bool threw = false;
+  try {
+    writer.close();
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  CHECK(threw);
+}
+
+} // namespace
+
+int main() {
+  test_round_trip();
+  test_truncated();
+  test_bad_size();
+  test_bad_header();
+  test_write_error();
+  std::filesystem::remove(PATH);
+  return CHECK_RESULT();
+}
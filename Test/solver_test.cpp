@@ -0,0 +1,110 @@
+#include "Check.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "Deck.h"
+#include "GameState.h"
+#include "Solver.h"
+
+namespace {
+
+// Endgames of n cards per player, taken from random deals
+void random_hands(Random &rng, int n, Hand (&hands)[3]) {
+  Deal deal = Deck(rng).deal();
+  for (int p = 0; p < 3; p++) {
+    std::vector<Card> cards = deal.hands[p].to_vector();
+    while ((int)cards.size() > n) {
+      cards.erase(cards.begin() + rng.bounded(cards.size()));
+    }
+    hands[p] = Hand(cards);
+  }
+}
+
+void test_hash_covers_landlord() {
+  Random rng(1);
+  Hand hands[3];
+  random_hands(rng, 17, hands);
+  for (int a = 0; a < 3; a++) {
+    for (int b = a + 1; b < 3; b++) {
+      // Same hands, same player to move, only the landlord differs
+      GameState s1(hands, a, 0, Move::none(), -1);
+      GameState s2(hands, b, 0, Move::none(), -1);
+      CHECK(s1.hash != s2.hash);
+    }
+  }
+}
+
+// A solver reused across landlords must give the results of fresh solvers
+void test_reuse_across_landlords() {
+  Random rng(2);
+  Solver reused(16);
+  int solved = 0;
+  for (int i = 0; i < 100; i++) {
+    Hand hands[3];
+    random_hands(rng, 5, hands);
+    for (int landlord = 0; landlord < 3; landlord++) {
+      GameState state(hands, landlord, 0, Move::none(), -1);
+      Solver fresh(16);
+      Solver::Result expected = fresh.solve(state);
+      Solver::Result result = reused.solve(state);
+      CHECK(result.win == expected.win);
+      solved++;
+    }
+  }
+  CHECK(solved == 300);
+}
+
+// Shared tables hold the positions of both solvers
+void test_shared_table() {
+  Random rng(3);
+  TranspositionTable table(16);
+  Solver s1(table), s2(table);
+  for (int i = 0; i < 50; i++) {
+    Hand hands[3];
+    random_hands(rng, 5, hands);
+    int landlord = rng.bounded(3);
+    GameState state(hands, landlord);
+    Solver fresh(16);
+    bool expected = fresh.solve(state).win;
+    CHECK(s1.solve(state).win == expected);
+    uint64_t nodes = s2.get_nodes();
+    CHECK(s2.solve(state).win == expected);
+    // s1 solved the root already, s2 finds it in the table
+    CHECK(s2.get_nodes() - nodes <= 1);
+  }
+}
+
+// Endgames of 10 cards per player: most deals take milliseconds, the longest
+// ones a few seconds. The bounds leave room for slower machines
+void test_ten_card_time() {
+  Random rng(4);
+  std::vector<double> times;
+  for (int i = 0; i < 20; i++) {
+    Hand hands[3];
+    random_hands(rng, 10, hands);
+    GameState state(hands, i % 3);
+    Solver solver;
+    auto start = std::chrono::steady_clock::now();
+    solver.solve(state);
+    times.push_back(std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+  }
+  std::sort(times.begin(), times.end());
+  std::cout << "10 cards: median " << times[times.size() / 2] * 1000
+            << " ms, worst " << times.back() * 1000 << " ms" << std::endl;
+  CHECK(times[times.size() / 2] < 0.1);
+  CHECK(times.back() < 10);
+}
+
+} // namespace
+
+int main() {
+  test_hash_covers_landlord();
+  test_reuse_across_landlords();
+  test_shared_table();
+  test_ten_card_time();
+  return CHECK_RESULT();
+}
@@ -0,0 +1,74 @@
+#include "Check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Random.h"
+#include "TranspositionTable.h"
+
+namespace {
+
+// The data every writer stores with key, never 0
+uint64_t data_of(uint64_t key) { return Random::mix(key) | 1; }
+
+void test_store_probe() {
+  TranspositionTable table(4);
+  uint64_t data;
+  CHECK(!table.probe(5, data));
+  table.store(5, 42);
+  CHECK(table.probe(5, data) && data == 42);
+  // Same slot, another key
+  CHECK(!table.probe(5 + 16, data));
+  table.store(5 + 16, 43);
+  CHECK(table.probe(5 + 16, data) && data == 43);
+  CHECK(!table.probe(5, data));
+  table.clear();
+  CHECK(!table.probe(5 + 16, data));
+}
+
+/**
+ * Writers store and readers probe the same few slots at once. Slots torn by
+ * two writes must look empty: a probe that succeeds gives the data stored
+ * with that very key.
+ */
+void test_threads() {
+  TranspositionTable table(6);
+  const int THREADS = 4;
+  const int ROUNDS = 200000;
+  std::atomic<int> wrong = 0, hits = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&, t]() {
+      Random rng(t);
+      int local_wrong = 0, local_hits = 0;
+      for (int i = 0; i < ROUNDS; i++) {
+        // Keys up to 4 times the slots, so they keep replacing each other
+        uint64_t key = Random::mix(rng.bounded(256)) | 1;
+        if (t % 2 == 0) {
+          table.store(key, data_of(key));
+        }
+        uint64_t data;
+        if (table.probe(key, data)) {
+          local_hits++;
+          local_wrong += data != data_of(key);
+        }
+      }
+      wrong += local_wrong;
+      hits += local_hits;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CHECK(wrong == 0);
+  CHECK(hits > 0);
+}
+
+} // namespace
+
+int main() {
+  test_store_probe();
+  test_threads();
+  return CHECK_RESULT();
+}